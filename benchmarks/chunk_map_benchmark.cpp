@@ -0,0 +1,153 @@
+// Compares the sharded ChunkMap with the map it replaced, a std::unordered_map behind one mutex.
+// Each thread does mostly lookups around a loaded area, like block and collision checks,
+// and some inserts and erases at its edge, like chunks being loaded and unloaded.
+// Built with -DMCPPSERVER_BUILD_BENCHMARKS=ON, run as chunk_map_benchmark [operations per thread].
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "world/chunk_map.h"
+
+// The maps only hold pointers, so the benchmark gets by without the real chunks
+class Chunk {};
+
+namespace {
+
+constexpr int32_t LOADED_RADIUS = 32;
+constexpr int32_t CHURN_RADIUS = 40;
+// One operation in this many is an insert or erase
+constexpr uint32_t WRITE_EVERY = 10;
+
+struct OldChunkCoordinates {
+    int32_t chunkX;
+    int32_t chunkZ;
+
+    bool operator==(const OldChunkCoordinates& other) const {
+        return chunkX == other.chunkX && chunkZ == other.chunkZ;
+    }
+};
+
+// The hash the old map used
+struct OldChunkCoordinatesHash {
+    size_t operator()(const OldChunkCoordinates& coords) const {
+        return std::hash<int32_t>()(coords.chunkX) ^ (std::hash<int32_t>()(coords.chunkZ) << 1);
+    }
+};
+
+class GlobalLockChunkMap {
+public:
+    std::shared_ptr<Chunk> find(int32_t chunkX, int32_t chunkZ) const {
+        std::lock_guard lock(mutex);
+        auto it = chunks.find({chunkX, chunkZ});
+        return it != chunks.end() ? it->second : nullptr;
+    }
+
+    std::shared_ptr<Chunk> insert(int32_t chunkX, int32_t chunkZ, std::shared_ptr<Chunk> chunk) {
+        std::lock_guard lock(mutex);
+        return chunks.try_emplace({chunkX, chunkZ}, std::move(chunk)).first->second;
+    }
+
+    bool erase(int32_t chunkX, int32_t chunkZ) {
+        std::lock_guard lock(mutex);
+        return chunks.erase({chunkX, chunkZ}) > 0;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<OldChunkCoordinates, std::shared_ptr<Chunk>, OldChunkCoordinatesHash> chunks;
+};
+
+// xorshift32, cheap enough not to show up in the timings
+struct Random {
+    uint32_t state;
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    int32_t coordinate(int32_t radius) {
+        return static_cast<int32_t>(next() % (2 * radius + 1)) - radius;
+    }
+};
+
+template <typename Map>
+double run(int threads, uint64_t operations) {
+    Map map;
+    auto chunk = std::make_shared<Chunk>();
+    for (int32_t x = -LOADED_RADIUS; x <= LOADED_RADIUS; ++x) {
+        for (int32_t z = -LOADED_RADIUS; z <= LOADED_RADIUS; ++z) {
+            map.insert(x, z, chunk);
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<uint64_t> hits(threads);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i] {
+            Random random{static_cast<uint32_t>(i) * 2654435761u + 1};
+            uint64_t found = 0;
+            for (uint64_t op = 0; op < operations; ++op) {
+                if (op % WRITE_EVERY == 0) {
+                    int32_t x = random.coordinate(CHURN_RADIUS);
+                    int32_t z = random.coordinate(CHURN_RADIUS);
+                    if (std::max(std::abs(x), std::abs(z)) <= LOADED_RADIUS) {
+                        continue;
+                    }
+                    if (random.next() & 1) {
+                        map.insert(x, z, chunk);
+                    } else {
+                        map.erase(x, z);
+                    }
+                } else if (map.find(random.coordinate(CHURN_RADIUS), random.coordinate(CHURN_RADIUS))) {
+                    ++found;
+                }
+            }
+            hits[i] = found;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Keeps the lookups from being optimized away
+    uint64_t totalHits = 0;
+    for (uint64_t found : hits) {
+        totalHits += found;
+    }
+    if (totalHits == 0) {
+        std::printf("no lookup hit a chunk\n");
+    }
+    return static_cast<double>(operations) * threads / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::printf("%-8s %18s %18s %8s\n", "threads", "global lock op/s", "sharded op/s", "speedup");
+    for (int threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        double global = run<GlobalLockChunkMap>(threads, operations);
+        double sharded = run<ChunkMap>(threads, operations);
+        std::printf("%-8d %18.0f %18.0f %7.2fx\n", threads, global, sharded, sharded / global);
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -2,6 +2,9 @@
 
 #include "networking/clientbound_packets.h"
 #include "core/config.h"
+#include "networking/packet_stats.h"
+#include "world/chunk_sender.h"
+#include "world/chunk_tickets.h"
 
 void buildAllCommands() {
     CommandBuilder builder;
@@ -914,6 +917,36 @@ void buildAllCommands() {
                     .end()                               // End argument node
             .end();                               // End "inventory" command node
 
+    // Network statistics command: /netstats [reset]
+    builder
+        .literal("netstats", true, true)
+            .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                sendOutput(formatPacketStats(10) + formatChunkSendStats(), false, {});
+            })
+            .literal("reset", true, true) // /netstats reset
+                .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                    resetPacketStats();
+                    sendOutput("Network statistics reset", false, {});
+                })
+                .end()
+            .end();                               // End "netstats" command node
+
+    // Stop command: /stop
+    builder
+        .literal("stop", true, true)
+            .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                stopServer();
+            })
+            .end();                               // End "stop" command node
+
+    // Loaded chunks command: /chunks
+    builder
+        .literal("chunks", true, true)
+            .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                sendOutput(chunkTickets.formatStats(), false, {});
+            })
+            .end();                               // End "chunks" command node
+
 
     // Build the command graph
     globalCommandGraph = builder.build();
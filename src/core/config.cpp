@@ -28,6 +28,8 @@ void loadConfig() {
         serverConfig.enableEncryption = true;
         serverConfig.enableCompression = true;
         serverConfig.compressionThreshold = 256;
+        serverConfig.compressionLevel = 6;
+        serverConfig.chunkCompressionLevel = 6;
         serverConfig.enableSecureChat = true;
         if (serverConfig.serverId.empty()) {
             serverConfig.serverId = generateServerID();
@@ -38,6 +40,23 @@ void loadConfig() {
         serverConfig.enableRcon = false;
         serverConfig.ticksPerSecond = 20;
         serverConfig.consoleLang = "en_us";
+        serverConfig.ioThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        serverConfig.outboundHighWaterMark = 4194304;
+        serverConfig.rsaKeyFile = "";
+        serverConfig.cryptoThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        serverConfig.sessionServerUrl = "https://sessionserver.mojang.com";
+        serverConfig.sessionTimeoutMs = 5000;
+        serverConfig.sessionThreads = 4;
+        serverConfig.statusPlayerSample = true;
+        serverConfig.statusRequestsPerSecond = 2;
+        serverConfig.maxChunksPerTick = 32;
+        serverConfig.chunkUnloadDelay = 10;
+        serverConfig.chunkMemoryBudgetMb = 1024;
+        serverConfig.spawnChunkRadius = 2;
+        serverConfig.regionFileCacheSize = 64;
+        serverConfig.autosaveInterval = 300;
+        serverConfig.entityTrackingRange = 8;
+        serverConfig.movementSyncInterval = 100;
         logMessage("Failed to open config file: " + configFilePath, LOG_ERROR);
         return;
     }
@@ -67,6 +86,8 @@ void loadConfig() {
     serverConfig.enableEncryption = (jsonConfig.value("enable_encryption", true) || serverConfig.onlineMode);
     serverConfig.enableCompression = jsonConfig.value("enable_compression", true);
     serverConfig.compressionThreshold = jsonConfig.value("compression_threshold", 256);
+    serverConfig.compressionLevel = std::clamp(jsonConfig.value("compression_level", 6), 1, 9);
+    serverConfig.chunkCompressionLevel = std::clamp(jsonConfig.value("chunk_compression_level", 6), 1, 9);
     serverConfig.enableSecureChat = jsonConfig.value("enable_secure_chat", true) && serverConfig.enableEncryption;
     if (serverConfig.serverId.empty()) {
         serverConfig.serverId = generateServerID();
@@ -175,5 +196,34 @@ void loadConfig() {
 
     serverConfig.ticksPerSecond = jsonConfig.value("ticks_per_second", 20);
     serverConfig.consoleLang = jsonConfig.value("console_language", "en_us");
+    // 0 picks half of the available hardware threads
+    serverConfig.ioThreads = jsonConfig.value("io_threads", 0);
+    if (serverConfig.ioThreads <= 0) {
+        serverConfig.ioThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    serverConfig.outboundHighWaterMark = std::max(jsonConfig.value("outbound_high_water_mark", 4194304), 65536);
+    // Empty generates a new key pair on every start
+    serverConfig.rsaKeyFile = jsonConfig.value("rsa_key_file", "");
+    if (!serverConfig.rsaKeyFile.empty() && !isAbsolutePath(serverConfig.rsaKeyFile)) {
+        serverConfig.rsaKeyFile = configDirectory + "/" + serverConfig.rsaKeyFile;
+    }
+    serverConfig.cryptoThreads = jsonConfig.value("crypto_threads", 0);
+    if (serverConfig.cryptoThreads <= 0) {
+        serverConfig.cryptoThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    serverConfig.sessionServerUrl = jsonConfig.value("session_server_url", "https://sessionserver.mojang.com");
+    serverConfig.sessionTimeoutMs = std::max(jsonConfig.value("session_timeout_ms", 5000), 100);
+    serverConfig.sessionThreads = std::max(jsonConfig.value("session_threads", 4), 1);
+    serverConfig.statusPlayerSample = jsonConfig.value("status_player_sample", true);
+    // 0 disables the per-IP limit
+    serverConfig.statusRequestsPerSecond = std::max(jsonConfig.value("status_requests_per_second", 2.0), 0.0);
+    serverConfig.maxChunksPerTick = std::clamp(jsonConfig.value("max_chunks_per_tick", 32), 1, 64);
+    serverConfig.chunkUnloadDelay = std::clamp(jsonConfig.value("chunk_unload_delay", 10), 0, 3600);
+    serverConfig.chunkMemoryBudgetMb = std::max(jsonConfig.value("chunk_memory_budget_mb", 1024), 16);
+    serverConfig.spawnChunkRadius = std::clamp(jsonConfig.value("spawn_chunk_radius", 2), 0, 16);
+    serverConfig.regionFileCacheSize = std::clamp(jsonConfig.value("region_file_cache_size", 64), 1, 1024);
+    serverConfig.autosaveInterval = std::clamp(jsonConfig.value("autosave_interval", 300), 0, 86400);
+    serverConfig.entityTrackingRange = std::clamp(jsonConfig.value("entity_tracking_range", 8), 1, 32);
+    serverConfig.movementSyncInterval = std::clamp(jsonConfig.value("movement_sync_interval", 100), 1, 1200);
 }
 
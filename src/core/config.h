@@ -41,6 +41,9 @@ struct ServerConfig {
     bool enableEncryption;
     bool enableCompression;
     int compressionThreshold;
+    // zlib levels for regular packets and chunk data
+    int compressionLevel;
+    int chunkCompressionLevel;
     bool enableSecureChat;
     std::string serverId{};
     int opPermissionLevel;
@@ -57,6 +60,38 @@ struct ServerConfig {
     WorldBorderConfig worldBorder;
     int ticksPerSecond;
     std::string consoleLang;
+    // Networking
+    int ioThreads;
+    // Queued bytes per client before packets are flushed ahead of the tick
+    int outboundHighWaterMark;
+    // Login
+    std::string rsaKeyFile;
+    int cryptoThreads;
+    // Base URL (scheme://host[:port]) of the session server, e.g. a local mock for load tests
+    std::string sessionServerUrl;
+    int sessionTimeoutMs;
+    int sessionThreads;
+    // Server list ping
+    bool statusPlayerSample;
+    double statusRequestsPerSecond;
+    // Chunks
+    // Upper bound for the chunks per tick a client may ask for
+    int maxChunksPerTick;
+    // Seconds a chunk stays loaded after its last ticket is released
+    int chunkUnloadDelay;
+    // Loaded chunks above this size are unloaded before the delay runs out
+    int chunkMemoryBudgetMb;
+    // Chunks around the world spawn that are always kept loaded
+    int spawnChunkRadius;
+    // Region files kept open between chunk loads and saves
+    int regionFileCacheSize;
+    // Seconds between autosaves of the changed chunks, 0 disables them
+    int autosaveInterval;
+    // Entities
+    // Chunks around a player in which entities are sent to it, capped by the view distance
+    int entityTrackingRange;
+    // Ticks between absolute position updates of a moving player, relative moves are sent in between
+    int movementSyncInterval;
 };
 
 extern ServerConfig serverConfig;
@@ -2,17 +2,33 @@
 #include "networking/network.h"
 #include "networking/client.h"
 #include "config.h"
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
 #include <thread>
 
 #include "commands/CommandBuilder.h"
 #include "data/crafting_recipes.h"
+#include "encryption/mojang_keys.h"
 #include "entities/item_entity.h"
+#include "entities/movement_sync.h"
 #include "networking/clientbound_packets.h"
+#include "registries/registry_manager.h"
 #include "server/query_server.h"
 #include "server/rcon_server.h"
 #include "utils/translation.h"
+#include "world/chunk_sender.h"
+#include "world/chunk_tickets.h"
 #include "world/world.h"
+#include "world/world_saver.h"
+
+// Set by the signal handler, the tick thread then stops the server
+static std::atomic<bool> stopRequested{false};
+
+static void requestStop(int) {
+    stopRequested = true;
+}
 
 void tickingSystem() {
     using namespace std::chrono;
@@ -30,18 +46,20 @@ void tickingSystem() {
     while (true) {
         // Wait until the next tick
         std::this_thread::sleep_until(nextTick);
+        if (stopRequested) {
+            stopServer();
+        }
         // Increment world time
         worldTime.tick();
         if (tickCount % 20 == 0) {
             // Every second
 
             // Notify all connected clients about the updated time
-            {
-                std::lock_guard lock(connectedClientsMutex);
-                for (auto &existingClient: connectedClients | std::views::values) {
-                    sendTimeUpdatePacket(*existingClient);
-                }
-            }
+            sendTimeUpdate();
+        }
+        if (tickCount % 600 == 0) {
+            // Every 30 seconds, like the vanilla server
+            sendLatencyUpdate();
         }
 
         // Update weather
@@ -204,6 +222,8 @@ void tickingSystem() {
             // Send relative move packet to clients
             sendEntityRelativeMovePacket(item, deltaXShort, deltaYShort, deltaZShort);
             sendEntityVelocity(item);
+            // Players it came close to get it spawned at its new position
+            entityTracker.updateEntity(item);
             // Items crossing a block boundary are processed every 2 ticks
             if (tickCount % 2 == 0 &&
             (static_cast<int32_t>(std::floor(item->getPositionX())) != static_cast<int32_t>(std::floor(oldPosX)) ||
@@ -223,6 +243,30 @@ void tickingSystem() {
             }
         }
 
+        // Save and evict the chunks nobody holds a ticket for anymore
+        if (tickCount % 20 == 0) {
+            threadPool.enqueue([] {
+                // The pool keeps exceptions in a future nobody reads
+                try {
+                    chunkTickets.unloadChunks();
+                } catch (const std::exception& e) {
+                    logMessage("Failed to unload chunks: " + std::string(e.what()), LOG_ERROR);
+                }
+            });
+        }
+
+        // Copy the chunks due for the autosave, they are written in the background
+        worldSaver.tick();
+
+        // One combined movement update per moved player
+        tickPlayerMovement();
+
+        // Start the chunk batches the clients are ready for
+        tickChunkSending();
+
+        // Write out everything queued for the clients during this tick
+        connectionReactor.flushAll();
+
         // Schedule the next tick
         nextTick += tickInterval;
         tickCount++;
@@ -243,6 +287,21 @@ void stopMiningScheduler() {
 }
 
 
+void stopServer() {
+    // Only the first request saves, later ones return while it runs
+    static std::atomic<bool> stopping{false};
+    if (stopping.exchange(true)) {
+        return;
+    }
+    logMessage(getTranslation("commands.stop.stopping", consoleLang), LOG_INFO);
+    if (!World::save()) {
+        logMessage("Failed to save some chunks.", LOG_ERROR);
+    }
+    std::cout.flush();
+    // The other threads are still running, so the static destructors are skipped
+    std::quick_exit(0);
+}
+
 void runServer() {
     auto startTime = std::chrono::system_clock::now();
 
@@ -313,6 +372,9 @@ void runServer() {
     if (!world->load()) {
         logMessage("Failed to load world.", LOG_ERROR);
     }
+    addSpawnChunkTickets();
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
 
     blocks = loadBlocks("../resources/blocks.json");
     biomes = loadBiomes("../resources/biomes.json");
@@ -323,12 +385,28 @@ void runServer() {
     craftingRecipes = loadCraftingRecipes("../resources/recipes/crafting.json");
     blockTags = loadBlockTags(blocks, "../resources/block_tags.json");
     itemTags = loadItemTags(items, "../resources/item_tags.json");
+    // The server key pair is generated (or loaded) once and shared by every login
+    RegistryManager::getInstance().getRSAKeyPair();
+
+    // Registry data and tags are the same for every login
+    if (!RegistryManager::getInstance().buildConfigurationPackets()) {
+        logMessage("Failed to build the registry data packets.", LOG_ERROR);
+    }
+    if (serverConfig.enableSecureChat) {
+        MojangKeyCache::getInstance().start();
+    }
 
     auto endTime = std::chrono::system_clock::now();
     std::chrono::duration<double> elapsedSeconds = endTime - startTime;
     logMessage(getTranslation("server.start.time", consoleLang, std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(elapsedSeconds).count())), LOG_INFO);
     logMessage(getTranslation("server.start.port", consoleLang, std::to_string(serverConfig.port)), LOG_INFO);
 
+    // Client sockets are serviced by a fixed set of I/O threads.
+    // Started before any thread that may flush connections or queue work on the pools.
+    cryptoPool = std::make_unique<thread_pool>(serverConfig.cryptoThreads);
+    sessionPool = std::make_unique<thread_pool>(serverConfig.sessionThreads);
+    connectionReactor.start(serverConfig.ioThreads);
+
     // Initialize and start the QueryServer if enabled
     std::unique_ptr<QueryServer> queryServer;
     if (serverConfig.enableQuery) {
@@ -376,10 +454,12 @@ void runServer() {
             continue;
         }
 
-        std::thread(handleClient, clientSock).detach();
+        connectionReactor.addConnection(clientSock);
     }
 
+    connectionReactor.stop();
     stopMiningScheduler();
+    MojangKeyCache::getInstance().stop();
 
     if (serverConfig.enableRcon) {
         rconServer->stop();
@@ -8,6 +8,8 @@
 #include "data/data.h"
 #include "entities/entity.h"
 #include "entities/entity_manager.h"
+#include "entities/entity_tracker.h"
+#include "networking/connection_reactor.h"
 #include "world/flatworld.h"
 #include "server/rcon_server.h"
 #include "utils/thread_pool.h"
@@ -23,6 +25,8 @@ class RootNode;
 struct ClientConnection;
 
 void runServer();
+// Saves the world and exits, called by /stop and on SIGINT/SIGTERM
+void stopServer();
 
 enum class GameEvent : uint8_t {
     NoRespawnBlockAvailable = 0,
@@ -48,6 +52,7 @@ inline std::unordered_map<std::string, FlatWorldSettings> flatWorldPresets = loa
             "../resources/flatworld_presets.json");
 
 inline EntityManager entityManager;
+inline EntityTracker entityTracker;
 
 inline std::unordered_map<std::string, BiomeData> biomes;
 inline std::unordered_map<std::string, BlockData> blocks;
@@ -69,10 +74,16 @@ inline std::mutex playersMutex;
 inline std::thread miningThread;
 inline std::atomic<bool> miningRunning;
 
-inline std::unordered_map<std::string, ClientConnection*> connectedClients;
+inline std::unordered_map<std::string, std::shared_ptr<ClientConnection>> connectedClients;
 inline std::mutex connectedClientsMutex;
 
 inline thread_pool threadPool(std::thread::hardware_concurrency());
+// RSA decryption during login, sized from the config at startup
+inline std::unique_ptr<thread_pool> cryptoPool;
+// Session server requests, each worker keeps its own HTTP connection alive
+inline std::unique_ptr<thread_pool> sessionPool;
+
+inline ConnectionReactor connectionReactor;
 
 inline std::unique_ptr<RCONServer> rconServer;
 
@@ -405,74 +405,96 @@ std::vector<uint8_t> decompressGZip(const std::vector<uint8_t>& compressedData)
     return decompressedData;
 }
 
-std::vector<uint8_t> compressData(const std::vector<uint8_t>& data) {
-    z_stream zs = {};
-
-    if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("deflateInit failed while compressing.");
+// zlib streams are costly to set up, so every thread keeps one of each and resets it between packets
+struct DeflateContext {
+    z_stream stream{};
+    bool initialized = false;
+    int level = Z_DEFAULT_COMPRESSION;
+
+    ~DeflateContext() {
+        if (initialized) {
+            deflateEnd(&stream);
+        }
     }
+};
 
-    zs.next_in = const_cast<Bytef*>(data.data());
-    zs.avail_in = data.size();
-
-    int ret;
-    std::vector<uint8_t> out;
-
-    do {
-        char outbuffer[32768];
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = deflate(&zs, Z_FINISH);
+struct InflateContext {
+    z_stream stream{};
+    bool initialized = false;
 
-        if (out.size() < zs.total_out) {
-            out.insert(out.end(), outbuffer, outbuffer + sizeof(outbuffer) - zs.avail_out);
+    ~InflateContext() {
+        if (initialized) {
+            inflateEnd(&stream);
         }
-    } while (ret == Z_OK);
+    }
+};
 
-    deflateEnd(&zs);
+void compressData(const uint8_t* data, size_t size, std::vector<uint8_t>& out, int level) {
+    thread_local DeflateContext context;
+    z_stream& zs = context.stream;
 
-    if (ret != Z_STREAM_END) { // an error occurred that was not EOF
-        throw std::runtime_error("Exception during zlib compression.");
+    if (!context.initialized) {
+        if (deflateInit(&zs, level) != Z_OK) {
+            throw std::runtime_error("deflateInit failed while compressing.");
+        }
+        context.initialized = true;
+        context.level = level;
+    } else {
+        deflateReset(&zs);
+        if (context.level != level) {
+            if (deflateParams(&zs, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("deflateParams failed while compressing.");
+            }
+            context.level = level;
+        }
     }
 
-    return out;
-}
+    // Compress straight behind the existing content, deflateBound guarantees a single pass
+    size_t offset = out.size();
+    out.resize(offset + deflateBound(&zs, static_cast<uLong>(size)));
 
-// Decompress data using zlib (inflate)
-std::vector<uint8_t> decompressData(const std::vector<uint8_t>& data) {
-    z_stream zs = {};
+    zs.next_in = const_cast<Bytef*>(data);
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = out.data() + offset;
+    zs.avail_out = static_cast<uInt>(out.size() - offset);
 
-    if (inflateInit(&zs) != Z_OK) {
-        throw std::runtime_error("inflateInit failed while decompressing.");
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
+        out.resize(offset);
+        throw std::runtime_error("Exception during zlib compression.");
     }
+    out.resize(offset + zs.total_out);
+}
 
-    zs.next_in = const_cast<Bytef*>(data.data());
-    zs.avail_in = data.size();
-
-    int ret;
+std::vector<uint8_t> compressData(const std::vector<uint8_t>& data, int level) {
     std::vector<uint8_t> out;
+    compressData(data.data(), data.size(), out, level);
+    return out;
+}
 
-    do {
-        char outbuffer[32768];
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = inflate(&zs, 0);
+// Decompress data using zlib (inflate), the protocol tells the uncompressed size up front
+void decompressData(const uint8_t* data, size_t size, size_t uncompressedSize, std::vector<uint8_t>& out) {
+    thread_local InflateContext context;
+    z_stream& zs = context.stream;
 
-        if (out.size() < zs.total_out) {
-            out.insert(out.end(), outbuffer, outbuffer + sizeof(outbuffer) - zs.avail_out);
+    if (!context.initialized) {
+        if (inflateInit(&zs) != Z_OK) {
+            throw std::runtime_error("inflateInit failed while decompressing.");
         }
+        context.initialized = true;
+    } else {
+        inflateReset(&zs);
+    }
 
-    } while (ret == Z_OK);
-
-    inflateEnd(&zs);
+    // Reuses the capacity of the caller's buffer
+    out.resize(uncompressedSize);
+    zs.next_in = const_cast<Bytef*>(data);
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = out.data();
+    zs.avail_out = static_cast<uInt>(out.size());
 
-    if (ret != Z_STREAM_END) { // an error occurred that was not EOF
+    if (inflate(&zs, Z_FINISH) != Z_STREAM_END || zs.total_out != uncompressedSize) {
         throw std::runtime_error("Exception during zlib decompression.");
     }
-
-    return out;
 }
 
 std::string computeServerHash(const std::string& serverId, const std::array<uint8_t, 16>& sharedSecret, const std::vector<uint8_t>& serverPublicKey) {
@@ -109,8 +109,10 @@ uint64_t encodePosition(int32_t x, int32_t y, int32_t z);
 void decodePosition(uint64_t val, int32_t &x, int32_t &y, int32_t &z);
 std::vector<uint8_t> compressGZip(const std::vector<uint8_t>& data);
 std::vector<uint8_t> decompressGZip(const std::vector<uint8_t>& compressedData);
-std::vector<uint8_t> compressData(const std::vector<uint8_t>& data);
-std::vector<uint8_t> decompressData(const std::vector<uint8_t>& data);
+// level follows zlib, -1 is the zlib default
+void compressData(const uint8_t* data, size_t size, std::vector<uint8_t>& out, int level = -1);
+std::vector<uint8_t> compressData(const std::vector<uint8_t>& data, int level = -1);
+void decompressData(const uint8_t* data, size_t size, size_t uncompressedSize, std::vector<uint8_t>& out);
 std::string computeServerHash(const std::string& serverId, const std::array<uint8_t, 16>& sharedSecret, const std::vector<uint8_t>& serverPublicKey);
 std::string getClientIPAddress(const ClientConnection& client);
 std::string generateServerID();
@@ -0,0 +1,99 @@
+#include "mojang_keys.h"
+
+#include <openssl/x509.h>
+
+#include "core/utils.h"
+#include "networking/fetch.h"
+#include "utils/thread_pool.h"
+
+// Mojang rotates these keys rarely
+constexpr auto REFRESH_INTERVAL = std::chrono::hours(1);
+constexpr auto RETRY_INTERVAL = std::chrono::minutes(1);
+// Minimum time between two fetches, even when verifications keep asking for one
+constexpr auto MIN_REFRESH_SPACING = std::chrono::seconds(10);
+
+MojangKeyCache::KeySet::~KeySet() {
+    for (EVP_PKEY* key : keys) {
+        EVP_PKEY_free(key);
+    }
+}
+
+MojangKeyCache& MojangKeyCache::getInstance() {
+    static MojangKeyCache instance;
+    return instance;
+}
+
+void MojangKeyCache::start() {
+    {
+        std::lock_guard lock(mutex);
+        if (running) {
+            return;
+        }
+        running = true;
+    }
+
+    refresh();
+    refreshThread = std::thread(&MojangKeyCache::run, this);
+    set_thread_name(refreshThread, "MojangKeys");
+}
+
+void MojangKeyCache::stop() {
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+    }
+    wakeup.notify_all();
+    if (refreshThread.joinable()) {
+        refreshThread.join();
+    }
+}
+
+std::shared_ptr<const MojangKeyCache::KeySet> MojangKeyCache::getKeys() {
+    std::lock_guard lock(mutex);
+    if (!keys) {
+        // Let the background thread retry right away instead of waiting for the next interval
+        refreshRequested = true;
+        wakeup.notify_all();
+    }
+    return keys;
+}
+
+bool MojangKeyCache::refresh() {
+    std::vector<std::string> encodedKeys = fetchMojangPublicKeys();
+
+    auto keySet = std::make_shared<KeySet>();
+    for (const auto& keyBase64 : encodedKeys) {
+        std::vector<uint8_t> der = base64Decode(keyBase64);
+        const unsigned char* data = der.data();
+        if (EVP_PKEY* key = d2i_PUBKEY(nullptr, &data, static_cast<long>(der.size()))) {
+            keySet->keys.push_back(key);
+        }
+    }
+    if (keySet->keys.empty()) {
+        logMessage("Failed to load Mojang public keys, keeping the previous ones.", LOG_WARNING);
+        return false;
+    }
+
+    logMessage("Loaded " + std::to_string(keySet->keys.size()) + " Mojang public keys.", LOG_DEBUG);
+    std::lock_guard lock(mutex);
+    keys = std::move(keySet);
+    return true;
+}
+
+void MojangKeyCache::run() {
+    std::unique_lock lock(mutex);
+    while (running) {
+        auto interval = keys ? std::chrono::steady_clock::duration(REFRESH_INTERVAL) : std::chrono::steady_clock::duration(RETRY_INTERVAL);
+        wakeup.wait_for(lock, interval, [this] { return !running || refreshRequested; });
+        if (!running) {
+            break;
+        }
+        refreshRequested = false;
+
+        lock.unlock();
+        refresh();
+        lock.lock();
+
+        wakeup.wait_for(lock, MIN_REFRESH_SPACING, [this] { return !running; });
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef MOJANG_KEYS_H
+#define MOJANG_KEYS_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <openssl/evp.h>
+
+// Mojang's public keys for profile and session key signatures.
+// Fetched at startup and refreshed in the background, so verification never waits on the network.
+class MojangKeyCache {
+public:
+    struct KeySet {
+        std::vector<EVP_PKEY*> keys;
+        ~KeySet();
+    };
+
+    static MojangKeyCache& getInstance();
+
+    MojangKeyCache(const MojangKeyCache&) = delete;
+    MojangKeyCache& operator=(const MojangKeyCache&) = delete;
+
+    // Fetches the keys once, then keeps them fresh on a background thread
+    void start();
+    void stop();
+
+    // Current key set, nullptr until a fetch succeeded
+    std::shared_ptr<const KeySet> getKeys();
+
+private:
+    MojangKeyCache() = default;
+
+    bool refresh();
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::shared_ptr<const KeySet> keys;
+    std::thread refreshThread;
+    bool running = false;
+    bool refreshRequested = false;
+};
+
+#endif // MOJANG_KEYS_H
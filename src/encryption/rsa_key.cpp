@@ -1,11 +1,42 @@
 #include "rsa_key.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include <openssl/err.h>
+#include <openssl/pem.h>
 #include <stdexcept>
 #include <openssl/x509.h>
 
-RSAKeyPair::RSAKeyPair()
+#include "core/utils.h"
+
+RSAKeyPair::RSAKeyPair(const std::string& keyFile)
     : pkey_(nullptr, EVP_PKEY_free)
 {
+    bool keyFileExists = !keyFile.empty() && std::filesystem::exists(keyFile);
+    if (keyFileExists) {
+        pkey_.reset(load(keyFile));
+        if (!pkey_) {
+            // Keep the file as it is, it may just be the wrong path
+            logMessage("Failed to load server key pair from " + keyFile + ", generating a temporary one.", LOG_WARNING);
+        }
+    }
+
+    if (!pkey_) {
+        pkey_.reset(generate());
+        if (!keyFile.empty() && !keyFileExists) {
+            save(pkey_.get(), keyFile);
+        }
+    }
+
+    // Sent in every Encryption Request and hashed for every online mode login
+    publicKeyDER_ = encodePublicKeyDER();
+}
+
+EVP_PKEY* RSAKeyPair::generate() {
     /// Generate RSA key using EVP_PKEY_Q_keygen
     // Parameters:
     // libctx = NULL (default library context)
@@ -22,7 +53,52 @@ RSAKeyPair::RSAKeyPair()
         throw std::runtime_error(std::string("EVP_PKEY_Q_keygen failed: ") + errMsg);
     }
 
-    pkey_.reset(generated_pkey);
+    return generated_pkey;
+}
+
+EVP_PKEY* RSAKeyPair::load(const std::string& keyFile) {
+    BIO* bio = BIO_new_file(keyFile.c_str(), "r");
+    if (!bio) {
+        return nullptr;
+    }
+    EVP_PKEY* loaded = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+
+    // The key is used for RSA decryption only
+    if (loaded && EVP_PKEY_get_base_id(loaded) != EVP_PKEY_RSA) {
+        EVP_PKEY_free(loaded);
+        return nullptr;
+    }
+    return loaded;
+}
+
+void RSAKeyPair::save(EVP_PKEY* pkey, const std::string& keyFile) {
+#ifdef _WIN32
+    BIO* bio = BIO_new_file(keyFile.c_str(), "w");
+#else
+    // Private key, created readable by the owner only so it is never exposed, not even while being written
+    int fd = open(keyFile.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        logMessage("Failed to create " + keyFile + " to save the server key pair: " + std::strerror(errno), LOG_WARNING);
+        return;
+    }
+    BIO* bio = BIO_new_fd(fd, BIO_CLOSE);
+    if (!bio) {
+        close(fd);
+    }
+#endif
+    if (!bio) {
+        logMessage("Failed to open " + keyFile + " to save the server key pair.", LOG_WARNING);
+        return;
+    }
+    bool written = PEM_write_bio_PrivateKey(bio, pkey, nullptr, nullptr, 0, nullptr, nullptr) == 1;
+    BIO_free(bio);
+    if (!written) {
+        logMessage("Failed to save the server key pair to " + keyFile, LOG_WARNING);
+        // A partial key would fail to load on every start
+        std::error_code error;
+        std::filesystem::remove(keyFile, error);
+    }
 }
 
 RSAKeyPair::~RSAKeyPair() {
@@ -33,7 +109,7 @@ EVP_PKEY* RSAKeyPair::getPublicKey() const {
     return pkey_.get();
 }
 
-std::vector<uint8_t> RSAKeyPair::getPublicKeyDER() const {
+std::vector<uint8_t> RSAKeyPair::encodePublicKeyDER() const {
     std::vector<uint8_t> der;
 
     // Create a memory BIO to hold the DER-encoded public key
@@ -2,25 +2,34 @@
 #define RSA_KEY_H
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <openssl/evp.h>
 
 class RSAKeyPair {
 public:
-    RSAKeyPair();
+    // Loads the private key from keyFile (PEM) if it exists, otherwise generates one and saves it there.
+    // An empty path only generates.
+    explicit RSAKeyPair(const std::string& keyFile = "");
     ~RSAKeyPair();
 
     EVP_PKEY *getPublicKey() const;
 
     // Returns the public key in DER format
-    std::vector<uint8_t> getPublicKeyDER() const;
+    const std::vector<uint8_t>& getPublicKeyDER() const { return publicKeyDER_; }
 
     // Decrypts data using the private key
     std::vector<uint8_t> decrypt(const std::vector<uint8_t>& encryptedData) const;
 
 private:
+    static EVP_PKEY* generate();
+    static EVP_PKEY* load(const std::string& keyFile);
+    static void save(EVP_PKEY* pkey, const std::string& keyFile);
+    std::vector<uint8_t> encodePublicKeyDER() const;
+
     // Using EVP_PKEY for better abstraction
     std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> pkey_;
+    std::vector<uint8_t> publicKeyDER_;
 };
 
 #endif //RSA_KEY_H
@@ -3,7 +3,7 @@
 #include <functional>
 
 #include "entity.h"
-#include "networking/clientbound_packets.h"
+#include "core/server.h"
 
 int32_t EntityManager::generateUniqueEntityID() {
     return nextEntityID.fetch_add(1);
@@ -18,14 +18,19 @@ void EntityManager::addEntity(const std::shared_ptr<Entity>& entity) {
 }
 
 void EntityManager::removeEntity(const std::string& uuidString) {
-    std::lock_guard lock(mutex);
-    auto it = uuidToEntityID.find(uuidString);
-    if (it != uuidToEntityID.end()) {
-        int32_t entityID = it->second;
-        sendRemoveEntityPacket(entityID);
+    int32_t entityID;
+    {
+        std::lock_guard lock(mutex);
+        auto it = uuidToEntityID.find(uuidString);
+        if (it == uuidToEntityID.end()) {
+            return;
+        }
+        entityID = it->second;
         entitiesByID.erase(entityID);
         uuidToEntityID.erase(it);
     }
+    // Only the players tracking the entity have it spawned
+    entityTracker.removeEntity(entityID);
 }
 
 std::shared_ptr<Entity> EntityManager::getEntity(const std::string& uuidString) {
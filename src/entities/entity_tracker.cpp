@@ -0,0 +1,227 @@
+#include "entity_tracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ranges>
+
+#include "entity.h"
+#include "item_entity.h"
+#include "player.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+#include "networking/client.h"
+#include "networking/clientbound_packets.h"
+#include "networking/network.h"
+#include "world/chunk.h"
+
+static std::pair<int32_t, int32_t> getEntityChunk(const Entity& entity) {
+    // A player's chunk is the center of its view
+    if (entity.type == EntityType::Player) {
+        const auto& player = static_cast<const Player&>(entity);
+        return {player.currentChunkX, player.currentChunkZ};
+    }
+    return {getChunkCoordinate(entity.getPositionX()), getChunkCoordinate(entity.getPositionZ())};
+}
+
+// In chunks, never more than the chunks a client has
+static int getTrackingRange() {
+    return std::min(serverConfig.entityTrackingRange, serverConfig.viewDistance);
+}
+
+static bool isInTrackingRange(const Player& player, int32_t chunkX, int32_t chunkZ) {
+    int range = getTrackingRange();
+    return std::abs(player.currentChunkX - chunkX) <= range && std::abs(player.currentChunkZ - chunkZ) <= range;
+}
+
+static std::shared_ptr<ClientConnection> findConnection(const Player& player) {
+    std::lock_guard lock(connectedClientsMutex);
+    auto it = connectedClients.find(player.uuidString);
+    return it != connectedClients.end() ? it->second : nullptr;
+}
+
+static void sendEntitySpawn(ClientConnection& client, const std::shared_ptr<Entity>& entity) {
+    // An item's stack is in its metadata, the client gets both at once
+    if (entity->type == EntityType::Item) {
+        auto item = std::static_pointer_cast<Item>(entity);
+        sendBundleDelimiter(client);
+        sendSpawnEntityPacket(client, entity);
+        sendEntityMetadataPacket(client, item->getMetadata(), item->entityID);
+        sendBundleDelimiter(client);
+        return;
+    }
+    sendSpawnEntityPacket(client, entity);
+    // The spawn is at the current position, not the one the other trackers were last sent.
+    // All of them are realigned with a teleport on the next tick.
+    if (entity->type == EntityType::Player) {
+        static_cast<Player&>(*entity).movementSync.forceTeleport = true;
+    }
+}
+
+void EntityTracker::moveToChunk(TrackedEntity& tracked, int32_t chunkX, int32_t chunkZ, bool registered) {
+    int32_t entityID = tracked.entity->entityID;
+    if (registered) {
+        auto it = entitiesByChunk.find(packChunkCoordinates(tracked.chunkX, tracked.chunkZ));
+        if (it != entitiesByChunk.end()) {
+            std::erase(it->second, entityID);
+            if (it->second.empty()) {
+                entitiesByChunk.erase(it);
+            }
+        }
+    }
+    tracked.chunkX = chunkX;
+    tracked.chunkZ = chunkZ;
+    entitiesByChunk[packChunkCoordinates(chunkX, chunkZ)].push_back(entityID);
+}
+
+void EntityTracker::updateEntity(const std::shared_ptr<Entity>& entity) {
+    auto [chunkX, chunkZ] = getEntityChunk(*entity);
+    std::lock_guard lock(mutex);
+    auto [it, inserted] = entities.try_emplace(entity->entityID);
+    TrackedEntity& tracked = it->second;
+    // Players moving closer or away within the same chunk are handled by updatePlayer
+    if (!inserted && tracked.chunkX == chunkX && tracked.chunkZ == chunkZ) {
+        return;
+    }
+    if (inserted) {
+        tracked.entity = entity;
+    }
+    moveToChunk(tracked, chunkX, chunkZ, !inserted);
+
+    std::vector<std::shared_ptr<Player>> viewers;
+    {
+        std::lock_guard viewersLock(chunkViewersMutex);
+        auto viewersIt = chunkViewersMap.find(ChunkCoordinates{chunkX, chunkZ});
+        if (viewersIt != chunkViewersMap.end()) {
+            viewers = viewersIt->second;
+        }
+    }
+
+    // Packets are queued under the lock, so the spawns and removals of one entity
+    // reach a client in the order they were decided, whichever thread decided them
+    std::unordered_map<int32_t, std::shared_ptr<ClientConnection>> trackers;
+    for (const auto& viewer : viewers) {
+        if (viewer->entityID == entity->entityID || !isInTrackingRange(*viewer, chunkX, chunkZ)) {
+            continue;
+        }
+        if (auto existing = tracked.trackers.find(viewer->entityID); existing != tracked.trackers.end()) {
+            trackers.emplace(existing->first, existing->second);
+            continue;
+        }
+        if (auto connection = findConnection(*viewer)) {
+            trackedByPlayer[viewer->entityID].insert(entity->entityID);
+            sendEntitySpawn(*connection, entity);
+            trackers.emplace(viewer->entityID, std::move(connection));
+        }
+    }
+    for (const auto& [playerID, connection] : tracked.trackers) {
+        if (trackers.contains(playerID)) {
+            continue;
+        }
+        if (auto tracking = trackedByPlayer.find(playerID); tracking != trackedByPlayer.end()) {
+            tracking->second.erase(entity->entityID);
+        }
+        sendRemoveEntityPacket(*connection, entity->entityID);
+    }
+    tracked.trackers = std::move(trackers);
+}
+
+void EntityTracker::updatePlayer(const std::shared_ptr<Player>& player) {
+    std::shared_ptr<ClientConnection> connection = findConnection(*player);
+    if (!connection) {
+        return;
+    }
+
+    // Packets are queued under the lock, like in updateEntity
+    std::lock_guard lock(mutex);
+    auto& tracking = trackedByPlayer[player->entityID];
+
+    // Stop tracking the entities that are now out of range
+    for (auto it = tracking.begin(); it != tracking.end();) {
+        auto tracked = entities.find(*it);
+        if (tracked != entities.end() && isInTrackingRange(*player, tracked->second.chunkX, tracked->second.chunkZ)) {
+            ++it;
+            continue;
+        }
+        if (tracked != entities.end()) {
+            tracked->second.trackers.erase(player->entityID);
+            sendRemoveEntityPacket(*connection, *it);
+        }
+        it = tracking.erase(it);
+    }
+
+    // Start tracking the entities in the chunks around the player
+    std::lock_guard viewersLock(chunkViewersMutex);
+    int range = getTrackingRange();
+    for (int32_t dx = -range; dx <= range; ++dx) {
+        for (int32_t dz = -range; dz <= range; ++dz) {
+            int32_t chunkX = player->currentChunkX + dx;
+            int32_t chunkZ = player->currentChunkZ + dz;
+            auto chunkIt = entitiesByChunk.find(packChunkCoordinates(chunkX, chunkZ));
+            if (chunkIt == entitiesByChunk.end() || !player->currentViewedChunks.contains(ChunkCoordinates{chunkX, chunkZ})) {
+                continue;
+            }
+            for (int32_t entityID : chunkIt->second) {
+                if (entityID == player->entityID || tracking.contains(entityID)) {
+                    continue;
+                }
+                TrackedEntity& tracked = entities.at(entityID);
+                tracked.trackers.emplace(player->entityID, connection);
+                tracking.insert(entityID);
+                sendEntitySpawn(*connection, tracked.entity);
+            }
+        }
+    }
+}
+
+void EntityTracker::removeEntity(int32_t entityID) {
+    std::lock_guard lock(mutex);
+    if (auto it = entities.find(entityID); it != entities.end()) {
+        for (const auto& [playerID, connection] : it->second.trackers) {
+            if (auto tracking = trackedByPlayer.find(playerID); tracking != trackedByPlayer.end()) {
+                tracking->second.erase(entityID);
+            }
+            sendRemoveEntityPacket(*connection, entityID);
+        }
+        if (auto chunkIt = entitiesByChunk.find(packChunkCoordinates(it->second.chunkX, it->second.chunkZ)); chunkIt != entitiesByChunk.end()) {
+            std::erase(chunkIt->second, entityID);
+            if (chunkIt->second.empty()) {
+                entitiesByChunk.erase(chunkIt);
+            }
+        }
+        entities.erase(it);
+    }
+
+    // A player that left no longer tracks anything
+    if (auto tracking = trackedByPlayer.find(entityID); tracking != trackedByPlayer.end()) {
+        for (int32_t trackedID : tracking->second) {
+            if (auto tracked = entities.find(trackedID); tracked != entities.end()) {
+                tracked->second.trackers.erase(entityID);
+            }
+        }
+        trackedByPlayer.erase(tracking);
+    }
+}
+
+void EntityTracker::broadcast(int32_t entityID, PacketWriter&& packet) {
+    std::vector<std::shared_ptr<ClientConnection>> recipients;
+    {
+        std::lock_guard lock(mutex);
+        auto it = entities.find(entityID);
+        if (it == entities.end()) {
+            return;
+        }
+        recipients.reserve(it->second.trackers.size());
+        for (const auto& connection : it->second.trackers | std::views::values) {
+            recipients.push_back(connection);
+        }
+    }
+    if (recipients.empty()) {
+        return;
+    }
+
+    EncodedPacket encoded(std::move(packet));
+    for (const auto& connection : recipients) {
+        sendPacket(*connection, encoded);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ENTITY_TRACKER_H
+#define ENTITY_TRACKER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "networking/packet_writer.h"
+
+class Entity;
+struct Player;
+struct ClientConnection;
+
+// Keeps, for every entity, the players that have it spawned on their client.
+// A player tracks an entity while it views the entity's chunk and is within the tracking range,
+// so entity packets only go to the players near it instead of to everyone.
+class EntityTracker {
+public:
+    // Re-evaluates who tracks the entity once it moved to another chunk, the first call registers it.
+    // Players that start tracking it get it spawned, players that stop get it removed.
+    void updateEntity(const std::shared_ptr<Entity>& entity);
+    // Re-evaluates which entities the player tracks once it moved to another chunk
+    void updatePlayer(const std::shared_ptr<Player>& player);
+    // Removes the entity from its trackers; a player also stops tracking everything
+    void removeEntity(int32_t entityID);
+
+    // Sends the packet to every player tracking the entity, it is encoded only once
+    void broadcast(int32_t entityID, PacketWriter&& packet);
+
+private:
+    struct TrackedEntity {
+        std::shared_ptr<Entity> entity;
+        int32_t chunkX = 0;
+        int32_t chunkZ = 0;
+        // Key: entity ID of the tracking player
+        std::unordered_map<int32_t, std::shared_ptr<ClientConnection>> trackers;
+    };
+
+    // Caller holds the mutex
+    void moveToChunk(TrackedEntity& tracked, int32_t chunkX, int32_t chunkZ, bool registered);
+
+    std::mutex mutex;
+    std::unordered_map<int32_t, TrackedEntity> entities;
+    // Entity IDs by packed chunk coordinates, to find the entities around a player
+    std::unordered_map<uint64_t, std::vector<int32_t>> entitiesByChunk;
+    // Entity IDs tracked by each player, key: entity ID of the player
+    std::unordered_map<int32_t, std::unordered_set<int32_t>> trackedByPlayer;
+};
+
+#endif // ENTITY_TRACKER_H
@@ -0,0 +1,97 @@
+#include "movement_sync.h"
+
+#include <cmath>
+#include <limits>
+#include <ranges>
+#include <vector>
+
+#include "player.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "networking/clientbound_packets.h"
+
+static int64_t toFixedPoint(double coordinate) {
+    return std::llround(coordinate * 4096.0);
+}
+
+static uint8_t toAngle(float degrees) {
+    return static_cast<uint8_t>(static_cast<int32_t>(std::floor(degrees * 256.0f / 360.0f)));
+}
+
+static bool fitsRelativeMove(int64_t delta) {
+    return delta >= std::numeric_limits<int16_t>::min() && delta <= std::numeric_limits<int16_t>::max();
+}
+
+static void sendMovement(const std::shared_ptr<Player>& player, MovementSync& sync, int64_t x, int64_t y, int64_t z, uint8_t yaw, uint8_t pitch, uint8_t headYaw, bool onGround) {
+    int64_t deltaX = x - sync.x;
+    int64_t deltaY = y - sync.y;
+    int64_t deltaZ = z - sync.z;
+    bool moved = deltaX != 0 || deltaY != 0 || deltaZ != 0;
+    bool rotated = yaw != sync.yaw || pitch != sync.pitch;
+    sync.movedSinceTeleport |= moved;
+    ++sync.ticksSinceTeleport;
+
+    bool forced = sync.forceTeleport.exchange(false);
+    bool resync = sync.movedSinceTeleport && sync.ticksSinceTeleport >= serverConfig.movementSyncInterval;
+    if (forced || resync || !fitsRelativeMove(deltaX) || !fitsRelativeMove(deltaY) || !fitsRelativeMove(deltaZ)) {
+        // Absolute position, clears whatever rounding the trackers accumulated
+        sendEntityTeleportPacket(player, x / 4096.0, y / 4096.0, z / 4096.0, yaw, pitch, onGround);
+        sync.ticksSinceTeleport = 0;
+        sync.movedSinceTeleport = false;
+    } else if (moved && rotated) {
+        sendEntityLookAndRelativeMovePacket(player, static_cast<short>(deltaX), static_cast<short>(deltaY), static_cast<short>(deltaZ), yaw, pitch, onGround);
+    } else if (moved) {
+        sendPlayerRelativeMovePacket(player, static_cast<short>(deltaX), static_cast<short>(deltaY), static_cast<short>(deltaZ), onGround);
+    } else if (rotated || onGround != sync.onGround) {
+        sendEntityRotationPacket(player, yaw, pitch, onGround);
+    }
+    if (headYaw != sync.headYaw) {
+        sendHeadRotationPacket(player, headYaw);
+    }
+}
+
+static void syncPlayerMovement(const std::shared_ptr<Player>& player) {
+    MovementSync& sync = player->movementSync;
+    int64_t x, y, z;
+    uint8_t yaw, pitch, headYaw;
+    bool onGround;
+    {
+        // The packets are built from this snapshot only, the handlers keep updating the player meanwhile
+        std::lock_guard lock(player->poseMutex);
+        x = toFixedPoint(player->position.x);
+        y = toFixedPoint(player->position.y);
+        z = toFixedPoint(player->position.z);
+        yaw = toAngle(player->rotation.yaw);
+        pitch = toAngle(player->rotation.pitch);
+        headYaw = toAngle(player->rotation.headYaw);
+        onGround = player->onGround;
+    }
+
+    // The spawn packet carried the pose the player had when it joined
+    if (sync.initialized) {
+        sendMovement(player, sync, x, y, z, yaw, pitch, headYaw, onGround);
+    }
+    sync.initialized = true;
+    sync.x = x;
+    sync.y = y;
+    sync.z = z;
+    sync.yaw = yaw;
+    sync.pitch = pitch;
+    sync.headYaw = headYaw;
+    sync.onGround = onGround;
+}
+
+void tickPlayerMovement() {
+    std::vector<std::shared_ptr<Player>> players;
+    {
+        std::lock_guard lock(playersMutex);
+        players.reserve(globalPlayers.size());
+        for (const auto& player : globalPlayers | std::views::values) {
+            players.push_back(player);
+        }
+    }
+
+    for (const auto& player : players) {
+        syncPlayerMovement(player);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MOVEMENT_SYNC_H
+#define MOVEMENT_SYNC_H
+
+#include <atomic>
+#include <cstdint>
+
+// Pose of a player as last sent to the players tracking it.
+// Positions are in 1/4096 of a block, the unit of the relative move packets, so deltas add up exactly.
+struct MovementSync {
+    bool initialized = false;
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t z = 0;
+    uint8_t yaw = 0;
+    uint8_t pitch = 0;
+    uint8_t headYaw = 0;
+    bool onGround = false;
+    int ticksSinceTeleport = 0;
+    bool movedSinceTeleport = false;
+    // Set when the player was spawned for a new tracker, which didn't get the deltas since the last teleport
+    std::atomic<bool> forceTeleport{false};
+};
+
+// Sends the movement of every player since the last tick to its trackers.
+// Any number of movement packets from a client end up as at most one move/look and one head rotation per tick.
+void tickPlayerMovement();
+
+#endif // MOVEMENT_SYNC_H
@@ -11,6 +11,12 @@
 #include "entity.h"
 #include "core/utils.h"
 #include "inventories/player_inventory.h"
+#include "movement_sync.h"
+#include "utils/task_strand.h"
+#include "world/chunk_sender.h"
+
+// Signature checks a player may have waiting before being kicked for spamming
+constexpr size_t MAX_PENDING_SIGNATURES = 32;
 
 struct Player : Entity {
     std::array<uint8_t, 16> uuid; // UUID as bytes
@@ -19,20 +25,30 @@ struct Player : Entity {
     std::unordered_map<std::string, std::pair<std::string, std::string>> properties; // property name -> (value, signature)
     Gamemode gameMode;
     bool listed; // Whether the player is listed on the player list
-    int32_t ping; // Ping in milliseconds
+    std::atomic<int32_t> ping = -1; // Smoothed round-trip time in milliseconds, -1 until measured
     int32_t currentChunkX;
     int32_t currentChunkZ;
     uint8_t flags; // Bitfield for player states
     ClientConnection* client;
     std::unordered_set<ChunkCoordinates> currentViewedChunks;
     std::unordered_set<ChunkCoordinates> loadedChunks;
+    // Guards loadedChunks, a chunk batch running on the thread pool only sends the chunks that are still in it
+    std::mutex loadedChunksMutex;
+    // Chunks in loadedChunks that haven't been sent yet
+    ChunkSendQueue chunkQueue;
     int viewDistance;
+    // Guards position, rotation and onGround, written by the packet handlers and read by the movement tick
+    std::mutex poseMutex;
+    // Movement is sent to the trackers once per tick
+    MovementSync movementSync;
     uint8_t activeSlot = 0;
     std::shared_ptr<PlayerInventory> inventory;
     std::shared_ptr<Inventory> currentInventory;
     std::vector<uint8_t> sessionId;
     PublicKey sessionKey;
     EVP_PKEY* publicKey = nullptr;
+    // Chat and session signatures are verified in order on the crypto pool
+    std::shared_ptr<TaskStrand> signatureStrand = std::make_shared<TaskStrand>(MAX_PENDING_SIGNATURES);
     std::string brand;
     std::string lang;
     uint8_t windowID = 0;
@@ -3,7 +3,7 @@
 #include "core/utils.h"
 #include "networking/network.h"
 
-Component parseComponent(const std::vector<uint8_t>& data, size_t& index) {
+Component parseComponent(std::span<const uint8_t> data, size_t& index) {
     Component component;
     size_t typeVarInt = parseVarInt(data, index);
     component.type = static_cast<ComponentType>(typeVarInt);
@@ -2,6 +2,7 @@
 #define SLOT_DATA_H
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <variant>
 #include <vector>
 
@@ -83,6 +84,6 @@ struct SlotData {
     std::optional<std::vector<ComponentType>> compsToRemove;
 };
 
-Component parseComponent(const std::vector<uint8_t>& data, size_t& index);
+Component parseComponent(std::span<const uint8_t> data, size_t& index);
 
 #endif //SLOT_DATA_H
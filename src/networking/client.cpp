@@ -1,5 +1,10 @@
 #include "client.h"
 #include "network.h"
+#include "connection_reactor.h"
+#include "packet_reader.h"
+#include "packet_stats.h"
+#include "status_response.h"
+#include "encryption/mojang_keys.h"
 #include "core/utils.h"
 #include "core/config.h"
 #include <iostream>
@@ -7,10 +12,12 @@
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include <openssl/err.h>
+#include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <openssl/x509.h>
 
 #include "world/chunk.h"
+#include "world/chunk_tickets.h"
 #include "clientbound_packets.h"
 #include "commands/CommandBuilder.h"
 #include "registries/dimension_type.h"
@@ -36,26 +43,26 @@ void disconnectClient(const std::shared_ptr<Player>& player, const std::string&
     if (disconnectPacket) {
         sendDisconnectionPacket(*player->client, reason);
         logMessage("Player " + player->name + " disconnected. Reason: " + reason, LOG_INFO);
-        // Close the socket
-#ifdef _WIN32
-        closesocket(player->client->socket);
-#else
-        close(player->client->socket);
-#endif
-    }
-    player->client->connectionClosed = true;
+        // Shut the socket down, the I/O thread owning it closes it
+        shutdownConnection(*player->client);
+    }
+    // Only clean up once, whichever side noticed the disconnect first
+    if (player->client->connectionClosed.exchange(true)) {
+        return;
+    }
     playersMutex.lock();
     globalPlayersName.erase(player->name);
     globalPlayers.erase(player->uuidString);
     playersMutex.unlock();
     --playerCount;
+    invalidateStatusResponse();
     connectedClientsMutex.lock();
     connectedClients.erase(player->uuidString);
     connectedClientsMutex.unlock();
 
     sendPlayerInfoRemove(player);
 
-    std::lock_guard lock(chunkMapMutex);
+    chunkViewersMutex.lock();
     for (auto it = chunkViewersMap.begin(); it != chunkViewersMap.end(); )
     {
         // Remove the player from the vector
@@ -73,121 +80,67 @@ void disconnectClient(const std::shared_ptr<Player>& player, const std::string&
             ++it; // Just advance the iterator
         }
     }
+    std::unordered_set<ChunkCoordinates> viewedChunks = std::move(player->currentViewedChunks);
+    player->currentViewedChunks.clear();
+    chunkViewersMutex.unlock();
 
-    sendTranslatedChatMessage("multiplayer.player.left", false, "yellow", nullptr, true, player->name);
-    entityManager.removeEntity(player->uuidString);
-}
-
-void handleStatusRequest(ClientConnection& client) {
-    // Read Status Request packet
-    std::vector<uint8_t> packetData;
-    // Read and respond to Ping packet
-    if (readUnencryptedPacket(client, packetData)) {
-        size_t index = 0;
-        int32_t packetID = parseVarInt(packetData, index);
-        if (packetID == STATUS_REQUEST) {
-            // Build JSON response using serverConfig
-            nlohmann::json responseJson = {
-                {"version", {{"name", serverConfig.server_version}, {"protocol", serverConfig.protocol_version}}},
-                {"players", {{"max", serverConfig.maxPlayers}, {"online", playerCount.load()}, {"sample", nlohmann::json::array()}}},
-                {"description", {{"text", serverConfig.motd}}}
-            };
-
-            // Add favicon if available
-            std::vector<uint8_t> faviconData = readFile(serverConfig.icon);
-            if (!faviconData.empty()) {
-                std::string faviconBase64 = base64Encode(faviconData);
-                responseJson["favicon"] = "data:image/png;base64," + faviconBase64;
-            }
-
-            std::string jsonResponse = responseJson.dump();
-
-            // Build response packet
-            std::vector<uint8_t> responseData;
-            responseData.push_back(STATUS_RESPONSE);
-            writeVarInt(responseData, static_cast<int32_t>(jsonResponse.size()));
-            responseData.insert(responseData.end(), jsonResponse.begin(), jsonResponse.end());
-
-            // Send response
-            sendUnencryptedPacket(client, responseData);
-
-            if (readPacketTimeout(client, packetData, 5000, true)) {
-                // Read Ping packet
-                index = 0;
-                packetID = parseVarInt(packetData, index);
-                if (packetID == PING_REQUEST) {
-                    // Ping packet
-                    std::vector<uint8_t> pongData;
-                    pongData.push_back(PONG_RESPONSE);
-                    pongData.insert(pongData.end(), packetData.begin() + index, packetData.end());
-                    sendUnencryptedPacket(client, pongData);
-                }
-            }
-        } else if (packetID == PING_REQUEST) {
-            // Ping packet
-            std::vector<uint8_t> pongData;
-            pongData.push_back(PONG_RESPONSE);
-            pongData.insert(pongData.end(), packetData.begin() + index, packetData.end());
-            sendUnencryptedPacket(client, pongData);
-        }
+    for (const auto& coords : viewedChunks) {
+        chunkTickets.remove(coords.chunkX, coords.chunkZ);
     }
-}
 
-void startKeepAliveLoop(ClientConnection& client) {
-    // Send Keep Alive packets every 15 seconds
-    while (true) {
-        std::this_thread::sleep_for(std::chrono::seconds(15));
-        if (client.connectionClosed || !sendKeepAlivePacket(client)) {
-            break;
-        }
-    }
+    sendTranslatedChatMessage("multiplayer.player.left", false, "yellow", nullptr, true, player->name);
+    entityManager.removeEntity(player->uuidString);
 }
 
-void handleKeepAliveResponse(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index) {
-    // Read the Keep Alive ID (Long)
-    if (index + 8 > packetData.size()) {
-        logMessage("Invalid Keep Alive packet received", LOG_WARNING);
-        return;
-    }
-
-    uint64_t keepAliveID = 0;
-    for (int i = 0; i < 8; ++i) {
-        keepAliveID = (keepAliveID << 8) | packetData[index + i];
-    }
-    logMessage("Received Keep Alive Response with ID: " + std::to_string(keepAliveID), LOG_DEBUG);
-
-    // TODO: verify that the keepAliveID matches the one sent
+bool handleStatusPacket(ClientConnection& client, std::span<const uint8_t> packetData) {
+    size_t index = 0;
+    int32_t packetID = parseVarInt(packetData, index);
+    if (packetID == STATUS_REQUEST) {
+        // The response is shared by all clients, no compression or encryption in the status state
+        std::shared_ptr<EncodedPacket> response = getStatusResponse();
+        // Send response and wait for the Ping packet
+        return sendPacket(client, *response);
+    }
+    if (packetID == PING_REQUEST) {
+        // Ping packet
+        PacketWriter pongData;
+        pongData.push_back(PONG_RESPONSE);
+        pongData.insert(pongData.end(), packetData.begin() + index, packetData.end());
+        sendUnencryptedPacket(client, std::move(pongData));
+    }
+    // The status exchange is over after the pong
+    return false;
 }
 
-void handleTeleportConfirm(ClientConnection& client, const std::vector<uint8_t>& packetData, size_t index, int teleportID) {
+void handleTeleportConfirm(ClientConnection& client, std::span<const uint8_t> packetData, size_t index, int teleportID) {
     client.state = ClientState::Play;
     // For now we don't need to do anything else
 }
 
-bool handleClientInformation(Player& player, const std::vector<uint8_t> & packetData, size_t index) {
+bool handleClientInformation(Player& player, std::span<const uint8_t> packetData, size_t index) {
     // Read Locale (String)
     std::string locale = parseString(packetData, index);
     player.lang = locale;
     // Read View Distance (Byte)
-    uint8_t viewDistance = packetData[index++];
+    uint8_t viewDistance = parseByte(packetData, index);
     player.viewDistance = viewDistance;
     // Read Chat Mode (VarInt)
     int32_t chatMode = parseVarInt(packetData, index);
     // Read Chat Colors (Boolean)
-    bool chatColors = packetData[index++] != 0;
+    bool chatColors = parseByte(packetData, index) != 0;
     // Read Displayed Skin Parts (Unsigned Byte)
-    uint8_t displayedSkinParts = packetData[index++];
+    uint8_t displayedSkinParts = parseByte(packetData, index);
     // Read Main Hand (VarInt)
     int32_t mainHand = parseVarInt(packetData, index);
     // Read Enable Text Filtering (Boolean)
-    bool enableTextFiltering = packetData[index++] != 0;
+    bool enableTextFiltering = parseByte(packetData, index) != 0;
     // Read Allow Server Listings (Boolean)
-    bool allowServerListings = packetData[index++] != 0;
+    bool allowServerListings = parseByte(packetData, index) != 0;
 
     return true;
 }
 
-bool handleZeroPacket(ClientConnection& client, const std::vector<uint8_t>& packetData, size_t index, const std::shared_ptr<Player>& player) {
+bool handleZeroPacket(ClientConnection& client, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player>& player) {
     // Attempt to parse the teleport ID first
     size_t unchangedIndex = index;
     int32_t teleportID = parseVarInt(packetData, index);
@@ -208,105 +161,114 @@ bool handleZeroPacket(ClientConnection& client, const std::vector<uint8_t>& pack
     return handleClientInformation(*player, packetData, unchangedIndex);
 }
 
-void handleClientSettings(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index) {
+void handleClientSettings(SocketType clientSock, std::span<const uint8_t> packetData, size_t index) {
 
 }
 
-void handlePlayerOnGround(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index, const std::shared_ptr<Player>& player) {
-    bool onGround = packetData[index++] != 0;
+void handlePlayerOnGround(SocketType clientSock, PacketReader& reader, const std::shared_ptr<Player>& player) {
+    bool onGround = reader.readBool();
+    std::lock_guard lock(player->poseMutex);
     player->onGround = onGround;
 }
 
-void handlePlayerRotation(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index, const std::shared_ptr<Player>& player) {
+void handlePlayerRotation(SocketType clientSock, PacketReader& reader, const std::shared_ptr<Player>& player) {
     // Read Yaw (Float)
-    float yaw = parseFloat(packetData, index);
+    float yaw = reader.readFloat();
     // Read Pitch (Float)
-    float pitch = parseFloat(packetData, index);
+    float pitch = reader.readFloat();
     // Read On Ground (Boolean)
-    bool onGround = packetData[index++] != 0;
+    bool onGround = reader.readBool();
 
-    // Update player state
+    // Update player state, the trackers get it at the end of the tick
+    std::lock_guard lock(player->poseMutex);
     player->rotation.yaw = yaw;
     player->rotation.pitch = pitch;
     player->rotation.headYaw = yaw;
     player->onGround = onGround;
+}
 
-    sendEntityRotationPacket(player);
-    sendHeadRotationPacket(player);
+static int getChunkViewDistance(const Player& player) {
+    return std::clamp(player.viewDistance, 2, serverConfig.viewDistance);
 }
 
-void handlePlayerPositionAndRotationPacket(ClientConnection& client, const std::vector<uint8_t> & vector, size_t size, const std::shared_ptr<Player>& player) {
-    double x = parseDouble(vector, size);
-    double feetY = parseDouble(vector, size);
-    double z = parseDouble(vector, size);
-    float yaw = parseFloat(vector, size);
-    float pitch = parseFloat(vector, size);
-    bool onGround = vector[size++] != 0;
+// Queues every chunk in view that the client doesn't have yet, nearest first
+// Caller holds the player's loadedChunksMutex
+static void queueChunksInView(const std::shared_ptr<Player>& player, int viewDistance) {
+    // Queued chunks that went out of view are forgotten before they are sent
+    for (const auto& coords : player->chunkQueue.recenter(player->currentChunkX, player->currentChunkZ, viewDistance, player->rotation.yaw)) {
+        player->loadedChunks.erase(coords);
+    }
+    for (const auto& coords : getChunksInView(player->currentChunkX, player->currentChunkZ, viewDistance)) {
+        // loadedChunks also holds the chunks that are still queued
+        if (player->loadedChunks.insert(coords).second) {
+            player->chunkQueue.enqueue(coords);
+        }
+    }
+}
 
-    // Calculate new chunk coordinates
-    int32_t newChunkX = getChunkCoordinate(x);
-    int32_t newChunkZ = getChunkCoordinate(z);
+static void updateCenterChunk(ClientConnection& client, const std::shared_ptr<Player>& player, int32_t newChunkX, int32_t newChunkZ) {
+    player->currentChunkX = newChunkX;
+    player->currentChunkZ = newChunkZ;
 
-    // Check if chunk coordinates have changed
-    if (newChunkX != player->currentChunkX || newChunkZ != player->currentChunkZ) {
-        int32_t oldChunkX = player->currentChunkX;
-        int32_t oldChunkZ = player->currentChunkZ;
+    // Send Set Center Chunk packet to the client
+    sendSetCenterChunkPacket(client, newChunkX, newChunkZ);
 
-        player->currentChunkX = newChunkX;
-        player->currentChunkZ = newChunkZ;
+    // Viewers, tickets, queued chunks and unloads all go by the same distance,
+    // even if the client changes its render distance meanwhile
+    int viewDistance = getChunkViewDistance(*player);
 
-        // Send Set Center Chunk packet to the client
-        sendSetCenterChunkPacket(client, newChunkX, newChunkZ);
+    // Update chunk viewers
+    updatePlayerChunkView(player, newChunkX, newChunkZ, viewDistance);
 
-        // Update chunk viewers
-        updatePlayerChunkView(player, oldChunkX, oldChunkZ, newChunkX, newChunkZ);
+    // Spawn and remove entities, for this player and for the players around it
+    entityTracker.updatePlayer(player);
+    entityTracker.updateEntity(player);
 
-        std::vector<ChunkCoordinates> chunksToLoad = getChunksInView(newChunkX, newChunkZ, std::min(player->viewDistance, serverConfig.viewDistance));
+    std::lock_guard lock(player->loadedChunksMutex);
 
-        // Remove chunks that are already loaded
-        for (auto it = chunksToLoad.begin(); it != chunksToLoad.end();) {
-            if (player->loadedChunks.contains(*it)) {
-                it = chunksToLoad.erase(it);
-            } else {
-                ++it;
-            }
-        }
+    // The chunks go out with the next batches, paced by the client
+    queueChunksInView(player, viewDistance);
 
-        for(auto chunkCoord : chunksToLoad) {
-            player->loadedChunks.insert(chunkCoord);
-            // TODO: Remove unloaded chunks
-            if (auto chunk = getOrLoadChunk(chunkCoord.chunkX, chunkCoord.chunkZ)) {
-                sendChunkDataToPlayer(client, chunk);
-            }
+    // Let the client drop the chunks that are now well out of view
+    int unloadDistance = viewDistance + CHUNK_UNLOAD_MARGIN;
+    for (auto it = player->loadedChunks.begin(); it != player->loadedChunks.end();) {
+        if (std::abs(it->chunkX - newChunkX) > unloadDistance || std::abs(it->chunkZ - newChunkZ) > unloadDistance) {
+            sendUnloadChunkPacket(client, it->chunkX, it->chunkZ);
+            it = player->loadedChunks.erase(it);
+        } else {
+            ++it;
         }
     }
+}
 
-    // Calculate deltas
-    double deltaX = x - player->position.x;
-    double deltaY = feetY - player->position.y;
-    double deltaZ = z - player->position.z;
-    auto deltaXFixed = static_cast<short>(x * 4096 - player->position.x * 4096);
-    auto deltaYFixed = static_cast<short>(feetY * 4096 - player->position.y * 4096);
-    auto deltaZFixed = static_cast<short>(z * 4096 - player->position.z * 4096);
+void handlePlayerPositionAndRotationPacket(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player) {
+    double x = reader.readDouble();
+    double feetY = reader.readDouble();
+    double z = reader.readDouble();
+    float yaw = reader.readFloat();
+    float pitch = reader.readFloat();
+    bool onGround = reader.readBool();
 
-    // Update server state
-    player->position.x = x;
-    player->position.y = feetY;
-    player->position.z = z;
-    player->rotation.yaw = yaw;
-    player->rotation.pitch = pitch;
-    player->rotation.headYaw = yaw;
-    player->onGround = onGround;
+    // Calculate new chunk coordinates
+    int32_t newChunkX = getChunkCoordinate(x);
+    int32_t newChunkZ = getChunkCoordinate(z);
 
-    // Decide which packet to send based on movement magnitude
-    if (std::abs(deltaX) < 7.999755859375 && std::abs(deltaY) < 7.999755859375 && std::abs(deltaZ) < 7.999755859375) {
-        // Small movement: Use Relative Move
-        sendEntityLookAndRelativeMovePacket(player, deltaXFixed, deltaYFixed, deltaZFixed, yaw, pitch);
-    } else {
-        // Large movement: Use Teleport
-        sendEntityTeleportPacket(player);
+    // Check if chunk coordinates have changed
+    if (newChunkX != player->currentChunkX || newChunkZ != player->currentChunkZ) {
+        updateCenterChunk(client, player, newChunkX, newChunkZ);
+    }
+
+    // Update server state, the trackers get the combined movement at the end of the tick
+    {
+        std::lock_guard lock(player->poseMutex);
+        player->position.x = x;
+        player->position.y = feetY;
+        player->position.z = z;
+        player->rotation.yaw = yaw;
+        player->rotation.pitch = pitch;
+        player->rotation.headYaw = yaw;
+        player->onGround = onGround;
     }
-    sendHeadRotationPacket(player);
 
     for (const auto &val: entityManager.getAllEntities() | std::views::values) {
         if (val->type == EntityType::Item) {
@@ -327,11 +289,11 @@ void handlePlayerPositionAndRotationPacket(ClientConnection& client, const std::
     }
 }
 
-void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>& vector, size_t& index, const std::shared_ptr<Player>& player) {
-    double x = parseDouble(vector, index);
-    double feetY = parseDouble(vector, index);
-    double z = parseDouble(vector, index);
-    bool onGround = vector[index++] != 0;
+void handlePlayerPosition(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player) {
+    double x = reader.readDouble();
+    double feetY = reader.readDouble();
+    double z = reader.readDouble();
+    bool onGround = reader.readBool();
 
     // Calculate new chunk coordinates
     int32_t newChunkX = getChunkCoordinate(x);
@@ -339,59 +301,16 @@ void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>&
 
     // Check if chunk coordinates have changed
     if (newChunkX != player->currentChunkX || newChunkZ != player->currentChunkZ) {
-        int32_t oldChunkX = player->currentChunkX;
-        int32_t oldChunkZ = player->currentChunkZ;
-
-        player->currentChunkX = newChunkX;
-        player->currentChunkZ = newChunkZ;
-
-        // Send Set Center Chunk packet to the client
-        sendSetCenterChunkPacket(client, newChunkX, newChunkZ);
-
-        // Update chunk viewers
-        updatePlayerChunkView(player, oldChunkX, oldChunkZ, newChunkX, newChunkZ);
-
-        std::vector<ChunkCoordinates> chunksToLoad = getChunksInView(newChunkX, newChunkZ, std::min(player->viewDistance, serverConfig.viewDistance));
-
-        // Remove chunks that are already loaded
-        for (auto it = chunksToLoad.begin(); it != chunksToLoad.end();) {
-            if (player->loadedChunks.contains(*it)) {
-                it = chunksToLoad.erase(it);
-            } else {
-                ++it;
-            }
-        }
-
-        for(auto chunkCoord : chunksToLoad) {
-            auto chunk = getOrLoadChunk(chunkCoord.chunkX, chunkCoord.chunkZ);
-            player->loadedChunks.insert(chunkCoord);
-            if (chunk) {
-                sendChunkDataToPlayer(client, chunk);
-            }
-        }
+        updateCenterChunk(client, player, newChunkX, newChunkZ);
     }
 
-    // Calculate deltas
-    double deltaX = x - player->position.x;
-    double deltaY = feetY - player->position.y;
-    double deltaZ = z - player->position.z;
-    auto deltaXFixed = static_cast<short>(x * 4096 - player->position.x * 4096);
-    auto deltaYFixed = static_cast<short>(feetY * 4096 - player->position.y * 4096);
-    auto deltaZFixed = static_cast<short>(z * 4096 - player->position.z * 4096);
-
-    // Update server state
-    player->position.x = x;
-    player->position.y = feetY;
-    player->position.z = z;
-    player->onGround = onGround;
-
-    // Decide which packet to send based on movement magnitude
-    if (std::abs(deltaX) < 7.999755859375 && std::abs(deltaY) < 7.999755859375 && std::abs(deltaZ) < 7.999755859375) {
-        // Small movement: Use Relative Move
-        sendPlayerRelativeMovePacket(player, deltaXFixed, deltaYFixed, deltaZFixed);
-    } else {
-        // Large movement: Use Teleport
-        sendEntityTeleportPacket(player);
+    // Update server state, the trackers get the combined movement at the end of the tick
+    {
+        std::lock_guard lock(player->poseMutex);
+        player->position.x = x;
+        player->position.y = feetY;
+        player->position.z = z;
+        player->onGround = onGround;
     }
 
     for (const auto &val: entityManager.getAllEntities() | std::views::values) {
@@ -413,7 +332,7 @@ void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>&
     }
 }
 
-void handlePlayerCommand(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handlePlayerCommand(SocketType socket, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     int32_t entityID = parseVarInt(packetData, index);
     int32_t actionID = parseVarInt(packetData, index);
     int32_t jumpBoost = parseVarInt(packetData, index);
@@ -433,7 +352,7 @@ void handlePlayerCommand(SocketType socket, const std::vector<uint8_t> & packetD
             writeVarInt(entries.at(1).value, 5); // Sneaking
 
             // Send the Entity Metadata Packet
-            sendEntityMetadataPacket(player, entries, entityID);
+            sendEntityMetadataPacket(entries, entityID);
             break;
         }
         case 1: // Stop Sneaking
@@ -450,7 +369,7 @@ void handlePlayerCommand(SocketType socket, const std::vector<uint8_t> & packetD
 
 
             // Send the Entity Metadata Packet
-            sendEntityMetadataPacket(player, entries, entityID);
+            sendEntityMetadataPacket(entries, entityID);
             break;
         }
         default: {
@@ -460,7 +379,7 @@ void handlePlayerCommand(SocketType socket, const std::vector<uint8_t> & packetD
     }
 }
 
-void handlePlayerSwingArm(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handlePlayerSwingArm(SocketType socket, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     switch (const size_t hand = parseVarInt(packetData, index)) {
         case 0: // Main Hand
             sendEntityAnimation(player, SWING_MAIN_ARM);
@@ -491,11 +410,8 @@ void spawnBlockDrops(int32_t x, int32_t y, int32_t z, int16_t blockState) {
 
         item->setCooldown(10); // 10 ticks before item can be picked up
 
-        // Send spawn packet with velocity
-        sendBundleDelimiter();
-        sendSpawnEntityPacket(item);
-        sendEntityMetadataPacket(item->getMetadata(), item->entityID);
-        sendBundleDelimiter();
+        // Spawned with its velocity for the players around it
+        entityTracker.updateEntity(item);
     }
 }
 
@@ -598,7 +514,7 @@ void miningScheduler(std::unordered_map<std::string, std::shared_ptr<Player>> &p
     }
 }
 
-void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handlePlayerActions(ClientConnection& client, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     auto action = static_cast<PlayerAction>(parseVarInt(packetData, index));
     uint64_t position = parseLong(packetData, index);
     int32_t x{};
@@ -690,7 +606,7 @@ void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> &
     }
 }
 
-void handleSetCreativeModeSlot(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handleSetCreativeModeSlot(SocketType socket, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     short slot = parseShort(packetData, index);
 
     SlotData slotDataParsed;
@@ -740,45 +656,45 @@ void handleSetCreativeModeSlot(SocketType socket, const std::vector<uint8_t> & p
         mainHandSlot.slotId = 0;
         mainHandSlot.slotData = slotDataParsed;
         player->equipment.mainHand = mainHandSlot;
-        sendEquipmentPacket(player, player->entityID, mainHandSlot);
+        sendEquipmentPacket(player->entityID, mainHandSlot);
     }
     if(slot == 45) {
         EquipmentSlot offHandSlot;
         offHandSlot.slotId = 1;
         offHandSlot.slotData = slotDataParsed;
         player->equipment.offHand = offHandSlot;
-        sendEquipmentPacket(player, player->entityID, offHandSlot);
+        sendEquipmentPacket(player->entityID, offHandSlot);
     } else if(slot == 5) {
         EquipmentSlot helmetSlot;
         helmetSlot.slotId = 5;
         helmetSlot.slotData = slotDataParsed;
         player->equipment.helmet = helmetSlot;
-        sendEquipmentPacket(player, player->entityID, helmetSlot);
+        sendEquipmentPacket(player->entityID, helmetSlot);
     } else if(slot == 6) {
         EquipmentSlot chestplateSlot;
         chestplateSlot.slotId = 4;
         chestplateSlot.slotData = slotDataParsed;
         player->equipment.helmet = chestplateSlot;
-        sendEquipmentPacket(player, player->entityID, chestplateSlot);
+        sendEquipmentPacket(player->entityID, chestplateSlot);
     } else if(slot == 7) {
         EquipmentSlot leggingsSlot;
         leggingsSlot.slotId = 3;
         leggingsSlot.slotData = slotDataParsed;
         player->equipment.helmet = leggingsSlot;
-        sendEquipmentPacket(player, player->entityID, leggingsSlot);
+        sendEquipmentPacket(player->entityID, leggingsSlot);
     } else if(slot == 8) {
         EquipmentSlot bootsSlot;
         bootsSlot.slotId = 2;
         bootsSlot.slotData = slotDataParsed;
         player->equipment.helmet = bootsSlot;
-        sendEquipmentPacket(player, player->entityID, bootsSlot);
+        sendEquipmentPacket(player->entityID, bootsSlot);
     }
 
     player->inventory->slots[slot] = slotDataParsed;
     SendSetContainerSlot(*player->client, 0, 0, slot, slotDataParsed);
 }
 
-void handleSetHeldItem(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handleSetHeldItem(SocketType socket, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     short slot = parseShort(packetData, index);
     player->activeSlot = slot;
 
@@ -787,14 +703,14 @@ void handleSetHeldItem(SocketType socket, const std::vector<uint8_t> & packetDat
         mainHandSlot.slotId = 0;
         mainHandSlot.slotData = player->inventory->slots.at(slot + 36);
         player->equipment.mainHand = mainHandSlot;
-        sendEquipmentPacket(player, player->entityID, mainHandSlot);
+        sendEquipmentPacket(player->entityID, mainHandSlot);
     } else {
         player->inventory->slots[slot + 36] = SlotData();
         EquipmentSlot mainHandSlot;
         mainHandSlot.slotId = 0;
         mainHandSlot.slotData = player->inventory->slots.at(slot + 36);
         player->equipment.mainHand = mainHandSlot;
-        sendEquipmentPacket(player, player->entityID, mainHandSlot);
+        sendEquipmentPacket(player->entityID, mainHandSlot);
     }
 }
 
@@ -875,7 +791,7 @@ bool interact(const std::shared_ptr<Player> & player, const Position & blockPos,
     return false;
 }
 
-void handleUseItemOn(ClientConnection& client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handleUseItemOn(ClientConnection& client, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     // Hand (VarInt)
     size_t hand = parseVarInt(packetData, index);
     // Position (Long/Position)
@@ -897,7 +813,7 @@ void handleUseItemOn(ClientConnection& client, const std::vector<uint8_t> & pack
     float cursorZ = parseFloat(packetData, index);
     cursorPosition = {cursorX, cursorY, cursorZ};
     // Inside Block (Boolean)
-    bool insideBlock = packetData[index++] != 0;
+    bool insideBlock = parseByte(packetData, index) != 0;
     // Sequence (VarInt)
     int32_t sequence = parseVarInt(packetData, index);
 
@@ -1023,65 +939,80 @@ bool verifySessionKeySignature(const std::shared_ptr<Player> & player, long expi
     return false; // Verification failed with all keys
 }
 
-void handlePlayerSession(ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handlePlayerSession(const std::shared_ptr<ClientConnection>& connection, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     // Read Session ID (UUID)
-    player->sessionId = parseBytes(packetData, index, 16);
+    std::vector<uint8_t> sessionId = parseBytes(packetData, index, 16);
 
     // Read Public Key
+    PublicKey sessionKey;
     // Expire at (Long)
-    player->sessionKey.expiresAt = parseLong(packetData, index);
+    sessionKey.expiresAt = parseLong(packetData, index);
 
     // Length of Public Key (VarInt)
     int32_t publicKeyLength = parseVarInt(packetData, index);
 
     // Public Key (Array of Bytes)
-    player->sessionKey.pubKey = parseBytes(packetData, index, publicKeyLength);
+    sessionKey.pubKey = parseBytes(packetData, index, publicKeyLength);
 
     // Length of Key Signature (VarInt)
     int32_t keySignatureLength = parseVarInt(packetData, index);
 
     // Key Signature (Array of Bytes)
-    player->sessionKey.keySig = parseBytes(packetData, index, keySignatureLength);
+    sessionKey.keySig = parseBytes(packetData, index, keySignatureLength);
 
-    if (serverConfig.enableSecureChat) {
-        // Parse the public key and store it
-        player->publicKey = parsePublicKey(player->sessionKey.pubKey);
-        if (!player->publicKey) {
-            disconnectClient(player, "Invalid public key.", true);
-            return;
-        }
+    if (!serverConfig.enableSecureChat) {
+        player->sessionId = std::move(sessionId);
+        player->sessionKey = std::move(sessionKey);
+        return;
+    }
 
-        // Fetch Mojang's public keys
-        std::vector<std::string> mojangPublicKeyPEMs = fetchMojangPublicKeys();
-        if (mojangPublicKeyPEMs.empty()) {
-            // Handle error
-            disconnectClient(player, "Unable to fetch Mojang public keys.", true);
+    // Verified on the player's strand, so chat messages sent after the session are checked against the new key
+    bool queued = player->signatureStrand->post(*cryptoPool, [connection, player, sessionId = std::move(sessionId), sessionKey = std::move(sessionKey)]() {
+        // Parse the public key
+        EVP_PKEY* publicKey = parsePublicKey(sessionKey.pubKey);
+        if (!publicKey) {
+            connectionReactor.post(connection, [player]() {
+                disconnectClient(player, "Invalid public key.", true);
+            });
             return;
         }
 
-        // Load and decode the public keys
-        std::vector<EVP_PKEY *> mojangPublicKeys;
-        for (const auto &keyBase64 : mojangPublicKeyPEMs) {
-            if (EVP_PKEY *pubKey = parsePublicKey(base64Decode(keyBase64))) {
-                mojangPublicKeys.push_back(pubKey);
-            }
-        }
-
-        // Verify the player's session key
-        if (mojangPublicKeys.empty()) {
-            disconnectClient(player, "Failed to load Mojang public keys.", true);
+        // Mojang's public keys, already fetched and parsed in the background
+        std::shared_ptr<const MojangKeyCache::KeySet> mojangPublicKeys = MojangKeyCache::getInstance().getKeys();
+        if (!mojangPublicKeys) {
+            EVP_PKEY_free(publicKey);
+            connectionReactor.post(connection, [player]() {
+                disconnectClient(player, "Unable to fetch Mojang public keys.", true);
+            });
             return;
         }
 
+        // Verify the player's session key
         // TODO: Fix key verification
-        if (!verifySessionKeySignature(player, player->sessionKey.expiresAt, player->sessionKey.pubKey, player->sessionKey.keySig, mojangPublicKeys)) {
+        if (!verifySessionKeySignature(player, sessionKey.expiresAt, sessionKey.pubKey, sessionKey.keySig, mojangPublicKeys->keys)) {
+            EVP_PKEY_free(publicKey);
             logMessage("Player: " + player->name + " failed to verify session key signature.", LOG_ERROR);
-            disconnectClient(player, "Invalid session key signature.", true);
+            connectionReactor.post(connection, [player]() {
+                disconnectClient(player, "Invalid session key signature.", true);
+            });
             return;
         }
 
-        std::vector<std::shared_ptr<Player>> playerInfo = {player};
-        sendPlayerInfoUpdate(client, playerInfo, 0x02);
+        // Only tasks on this strand read the session
+        if (player->publicKey) {
+            EVP_PKEY_free(player->publicKey);
+        }
+        player->publicKey = publicKey;
+        player->sessionId = sessionId;
+        player->sessionKey = sessionKey;
+
+        connectionReactor.post(connection, [connection, player]() {
+            std::vector<std::shared_ptr<Player>> playerInfo = {player};
+            sendPlayerInfoUpdate(*connection, playerInfo, 0x02);
+        });
+    });
+    if (!queued) {
+        disconnectClient(player, "Too many pending signature checks.", true);
     }
 }
 
@@ -1164,7 +1095,7 @@ bool verifyChatSignature(const std::shared_ptr<Player>& player, const std::strin
     return result;
 }
 
-void handleChatMessage(const ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player, const RegistryManager& registryManager) {
+void handleChatMessage(const ClientConnection & client, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player, const RegistryManager& registryManager) {
     // Message (String)
     std::string message = parseString(packetData, index);
 
@@ -1175,7 +1106,7 @@ void handleChatMessage(const ClientConnection & client, const std::vector<uint8_
     int64_t salt = parseLong(packetData, index);
 
     // Has Signature (Boolean)
-    bool hasSignature = packetData[index++] != 0;
+    bool hasSignature = parseByte(packetData, index) != 0;
 
     std::vector<uint8_t> signature;
 
@@ -1188,18 +1119,25 @@ void handleChatMessage(const ClientConnection & client, const std::vector<uint8_
 
     // Acknowledged (Fixed Bit Set) // TODO: Implement
 
-    if (hasSignature && serverConfig.enableSecureChat) {
-        // Verify the signature
-        std::vector<std::vector<uint8_t>> previousSignatures;
-        if (!verifyChatSignature(player, message, timestamp, salt, 0, signature, previousSignatures)) {
-            // Signature is invalid
-            logMessage("Player " + player->name + " sent an invalid chat message signature", LOG_ERROR);
-            return;
+    // Unsigned messages go through the strand too, so a player's messages keep their order.
+    // The registry manager is process-wide and outlives the task.
+    bool queued = player->signatureStrand->post(*cryptoPool, [player, message = std::move(message), timestamp, salt, hasSignature, signature = std::move(signature), &registryManager]() {
+        if (hasSignature && serverConfig.enableSecureChat) {
+            // Verify the signature
+            std::vector<std::vector<uint8_t>> previousSignatures;
+            if (!verifyChatSignature(player, message, timestamp, salt, 0, signature, previousSignatures)) {
+                // Signature is invalid
+                logMessage("Player " + player->name + " sent an invalid chat message signature", LOG_ERROR);
+                return;
+            }
         }
-    }
 
-    // Broadcast the chat message to all players
-    broadcastPlayerChatMessage(player, message, timestamp, salt, hasSignature ? &signature : nullptr, registryManager);
+        // Broadcast the chat message to all players
+        broadcastPlayerChatMessage(player, message, timestamp, salt, hasSignature ? &signature : nullptr, registryManager);
+    });
+    if (!queued) {
+        disconnectClient(player, "Kicked for spamming", true);
+    }
 }
 
 void handleCommand(ClientConnection & client, const std::shared_ptr<Player>& player, const std::string & command) {
@@ -1228,13 +1166,13 @@ void handleConsoleCommand(const std::string & command) {
     bool success = parser.parseAndExecuteConsole(command, consoleOutput);
 }
 
-void handleChatCommand(ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handleChatCommand(ClientConnection & client, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     std::string command = parseString(packetData, index);
     logMessage(player->name + " issued command: " + command, LOG_RAW);
     handleCommand(client, player, command);
 }
 
-void handlePluginMessage(const ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, Player& player) {
+void handlePluginMessage(const ClientConnection & client, std::span<const uint8_t> packetData, size_t index, Player& player) {
     std::string channel = parseString(packetData, index);
 
     if (channel == "minecraft:brand") {
@@ -1244,7 +1182,7 @@ void handlePluginMessage(const ClientConnection & client, const std::vector<uint
     }
 }
 
-void handleResourcePackResponse(const ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handleResourcePackResponse(const ClientConnection & client, std::span<const uint8_t> packetData, size_t index, const std::shared_ptr<Player> & player) {
     // Resource Pack UUID (Bytes)
     std::vector<uint8_t> resourcePackUUID = parseBytes(packetData, index, 16);
     std::array<uint8_t, 16> resourcePackUUIDArray{};
@@ -1281,13 +1219,13 @@ void handleResourcePackResponse(const ClientConnection & client, const std::vect
     }
 }
 
-void handleCommandSuggestionsRequest(ClientConnection & client, const std::vector<uint8_t> & vector, size_t size, const std::shared_ptr<Player> & shared) {
+void handleCommandSuggestionsRequest(ClientConnection & client, std::span<const uint8_t> vector, size_t size, const std::shared_ptr<Player> & shared) {
     int32_t transactionID = parseVarInt(vector, size);
     std::string command = parseString(vector, size);
-    if (command[0] == '/') {
+    if (command.starts_with('/')) {
         command = command.substr(1);
     }
-    if (command.back() == ' ') {
+    if (command.ends_with(' ')) {
         command.pop_back();
     }
     if (command.find("bossbar set") == 0 && command.find("color") != std::string::npos) {
@@ -1305,14 +1243,25 @@ void handleCommandSuggestionsRequest(ClientConnection & client, const std::vecto
     }
 }
 
-void handleKeepAlive(const ClientConnection & client, const std::vector<uint8_t> & packet, size_t index, const std::shared_ptr<Player> & player) {
-    int64_t keepAliveID = parseLong(packet, index);
-    if (keepAliveID != client.keepAliveID) {
+void handleKeepAlive(ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    int64_t keepAliveID = reader.readLong();
+    if (client.keepAliveSentAt == std::chrono::steady_clock::time_point{} || keepAliveID != client.keepAliveID) {
         logMessage("Keep Alive ID mismatch for player: " + player->name, LOG_WARNING);
+        return;
+    }
+
+    auto sample = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - client.keepAliveSentAt);
+    client.keepAliveSentAt = {};
+    // Exponentially weighted like TCP's SRTT, new samples count 1/8
+    if (client.smoothedRtt.count() == 0) {
+        client.smoothedRtt = sample;
+    } else {
+        client.smoothedRtt += (sample - client.smoothedRtt) / 8;
     }
+    player->ping = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(client.smoothedRtt).count());
 }
 
-void handleClickContainer(const ClientConnection & client, const std::vector<uint8_t> & packet, size_t index, const std::shared_ptr<Player> & player) {
+void handleClickContainer(const ClientConnection & client, std::span<const uint8_t> packet, size_t index, const std::shared_ptr<Player> & player) {
     uint8_t windowID = parseByte(packet, index);
     int32_t stateID = parseVarInt(packet, index);
     int16_t slot = parseShort(packet, index);
@@ -1329,7 +1278,7 @@ void handleClickContainer(const ClientConnection & client, const std::vector<uin
     player->currentInventory->HandleInventoryClick(windowID, stateID, slot, button, mode, changedSlotsFromClient, carriedItem);
 }
 
-void handleCloseContainer(const ClientConnection & client, const std::vector<uint8_t> & packet, size_t index, const std::shared_ptr<Player> & player) {
+void handleCloseContainer(const ClientConnection & client, std::span<const uint8_t> packet, size_t index, const std::shared_ptr<Player> & player) {
     uint8_t windowID = parseByte(packet, index);
     if (windowID != 0 && windowID == player->windowID) {
         // check if shared ptr inherits from specific class
@@ -1342,88 +1291,121 @@ void handleCloseContainer(const ClientConnection & client, const std::vector<uin
     }
 }
 
-void handleClientPacket(ClientConnection& client, const std::vector<uint8_t>& packetData, const std::shared_ptr<Player>& player, const RegistryManager& registryManager) {
-    size_t index = 0;
-
-    // Handle packets based on their IDs
-    switch (int32_t packetID = parseVarInt(packetData, index)) {
-        case ZERO_PACKET: // Client Info / Teleport Confirm
-            handleZeroPacket(client, packetData, index, player);
-            break;
-        case LOGIN_PLUGIN_RESPONSE: // Serverbound Plugin Message
-        case PLUGIN_MESSAGE_PLAY:
-            handlePluginMessage(client, packetData, index, *player);
-            break;
-        case CHAT_COMMAND: // Chat Command
-            handleChatCommand(client, packetData, index, player);
-            break;
-        case CHAT_MESSAGE: // Chat Message
-            handleChatMessage(client, packetData, index, player, registryManager);
-            break;
-        case PLAYER_SESSION: // Player Session
-            handlePlayerSession(client, packetData, index, player);
-            break;
-        case COMMAND_SUGGESTIONS_REQUEST: // Command Suggestions Request
-            handleCommandSuggestionsRequest(client, packetData, index, player);
-            break;
-        case CLICK_CONTAINER: // Click container slot
-            handleClickContainer(client, packetData, index, player);
-            break;
-        case CLOSE_CONTAINER: // Close container
-            handleCloseContainer(client, packetData, index, player);
-            break;
-        case SERVERBOUND_KEEP_ALIVE: // Keep Alive
-            handleKeepAlive(client, packetData, index, player);
-            break;
-        case PLAYER_POSITION: // Player Position
-            if (client.state != ClientState::AwaitingTeleportConfirm) {
-                handlePlayerPosition(client, packetData, index, player);
+// Everything a Play packet handler may need
+struct PlayPacketContext {
+    const std::shared_ptr<ClientConnection>& connection;
+    ClientConnection& client;
+    std::span<const uint8_t> packetData;
+    PacketReader& reader;
+    size_t index;
+    const std::shared_ptr<Player>& player;
+    const RegistryManager& registryManager;
+};
+
+using PlayPacketHandler = void (*)(PlayPacketContext&);
+
+// Play handlers indexed by packet ID, nullptr for packets the server ignores
+static const std::array<PlayPacketHandler, PACKET_ID_LIMIT>& playPacketHandlers() {
+    static const std::array<PlayPacketHandler, PACKET_ID_LIMIT> handlers = [] {
+        std::array<PlayPacketHandler, PACKET_ID_LIMIT> table{};
+        // Client Info / Teleport Confirm
+        table[ZERO_PACKET] = [](PlayPacketContext& context) {
+            handleZeroPacket(context.client, context.packetData, context.index, context.player);
+        };
+        table[LOGIN_PLUGIN_RESPONSE] = [](PlayPacketContext& context) {
+            handlePluginMessage(context.client, context.packetData, context.index, *context.player);
+        };
+        table[PLUGIN_MESSAGE_PLAY] = table[LOGIN_PLUGIN_RESPONSE];
+        table[CHAT_COMMAND] = [](PlayPacketContext& context) {
+            handleChatCommand(context.client, context.packetData, context.index, context.player);
+        };
+        table[CHAT_MESSAGE] = [](PlayPacketContext& context) {
+            handleChatMessage(context.client, context.packetData, context.index, context.player, context.registryManager);
+        };
+        table[PLAYER_SESSION] = [](PlayPacketContext& context) {
+            handlePlayerSession(context.connection, context.packetData, context.index, context.player);
+        };
+        table[COMMAND_SUGGESTIONS_REQUEST] = [](PlayPacketContext& context) {
+            handleCommandSuggestionsRequest(context.client, context.packetData, context.index, context.player);
+        };
+        table[CLICK_CONTAINER] = [](PlayPacketContext& context) {
+            handleClickContainer(context.client, context.packetData, context.index, context.player);
+        };
+        table[CLOSE_CONTAINER] = [](PlayPacketContext& context) {
+            handleCloseContainer(context.client, context.packetData, context.index, context.player);
+        };
+        table[CHUNK_BATCH_RECEIVED] = [](PlayPacketContext& context) {
+            // Chunks per tick the client wants to receive (Float)
+            context.player->chunkQueue.onBatchReceived(context.reader.readFloat());
+        };
+        table[SERVERBOUND_KEEP_ALIVE] = [](PlayPacketContext& context) {
+            handleKeepAlive(context.client, context.reader, context.player);
+        };
+        // Movement is ignored until the client confirmed the last teleport
+        table[PLAYER_POSITION] = [](PlayPacketContext& context) {
+            if (context.client.state != ClientState::AwaitingTeleportConfirm) {
+                handlePlayerPosition(context.client, context.reader, context.player);
             }
-            break;
-        case PLAYER_POSITION_AND_ROTATION: // Player Position and Rotation
-            if (client.state != ClientState::AwaitingTeleportConfirm) {
-                handlePlayerPositionAndRotationPacket(client, packetData, index, player);
+        };
+        table[PLAYER_POSITION_AND_ROTATION] = [](PlayPacketContext& context) {
+            if (context.client.state != ClientState::AwaitingTeleportConfirm) {
+                handlePlayerPositionAndRotationPacket(context.client, context.reader, context.player);
             }
-            break;
-        case Player_ROTATION: // Player Rotation
-            if (client.state != ClientState::AwaitingTeleportConfirm) {
-                handlePlayerRotation(client.socket, packetData, index, player);
+        };
+        table[Player_ROTATION] = [](PlayPacketContext& context) {
+            if (context.client.state != ClientState::AwaitingTeleportConfirm) {
+                handlePlayerRotation(context.client.socket, context.reader, context.player);
             }
-            break;
-        case PLAYER_ON_GROUND: // Player On Ground
-            handlePlayerOnGround(client.socket, packetData, index, player);
-            break;
-        case PLAYER_ACTION: // Player actions
-            handlePlayerActions(client, packetData, index, player);
-            break;
-        case PLAYER_COMMAND: // Player command
-            handlePlayerCommand(client.socket, packetData, index, player);
-            break;
-        case RESOURCE_PACK_RESPONSE_PLAY: // Resource Pack Response
-            handleResourcePackResponse(client, packetData, index, player);
-            break;
-        case HELD_ITEM: // Set Held Item
-            handleSetHeldItem(client.socket, packetData, index, player);
-            break;
-        case CREATIVE_MODE_SLOT: // Set Creative Mode Slot
-            handleSetCreativeModeSlot(client.socket, packetData, index, player);
-            break;
-        case SWING_ARM: // Swing arm
-            handlePlayerSwingArm(client.socket, packetData, index, player);
-            break;
-        case USE_ITEM_ON: // Use Item On
-            handleUseItemOn(client, packetData, index, player);
-            break;
-        default: // Unknown packet ID
-            std::stringstream stringstream;
-            stringstream << "Received unknown packet ID: 0x" << std::hex << packetID << std::dec; // Convert to hex and then back to dec
-            std::string formattedMessage = stringstream.str();
-            logMessage(formattedMessage, LOG_WARNING);
-            break;
+        };
+        table[PLAYER_ON_GROUND] = [](PlayPacketContext& context) {
+            handlePlayerOnGround(context.client.socket, context.reader, context.player);
+        };
+        table[PLAYER_ACTION] = [](PlayPacketContext& context) {
+            handlePlayerActions(context.client, context.packetData, context.index, context.player);
+        };
+        table[PLAYER_COMMAND] = [](PlayPacketContext& context) {
+            handlePlayerCommand(context.client.socket, context.packetData, context.index, context.player);
+        };
+        table[RESOURCE_PACK_RESPONSE_PLAY] = [](PlayPacketContext& context) {
+            handleResourcePackResponse(context.client, context.packetData, context.index, context.player);
+        };
+        table[HELD_ITEM] = [](PlayPacketContext& context) {
+            handleSetHeldItem(context.client.socket, context.packetData, context.index, context.player);
+        };
+        table[CREATIVE_MODE_SLOT] = [](PlayPacketContext& context) {
+            handleSetCreativeModeSlot(context.client.socket, context.packetData, context.index, context.player);
+        };
+        table[SWING_ARM] = [](PlayPacketContext& context) {
+            handlePlayerSwingArm(context.client.socket, context.packetData, context.index, context.player);
+        };
+        table[USE_ITEM_ON] = [](PlayPacketContext& context) {
+            handleUseItemOn(context.client, context.packetData, context.index, context.player);
+        };
+        return table;
+    }();
+    return handlers;
+}
+
+void handleClientPacket(const std::shared_ptr<ClientConnection>& connection, std::span<const uint8_t> packetData, const std::shared_ptr<Player>& player, const RegistryManager& registryManager) {
+    ClientConnection& client = *connection;
+    PacketReader reader(packetData);
+    int32_t packetID = reader.readVarInt();
+    size_t index = reader.position();
+
+    PlayPacketHandler handler = packetID >= 0 && packetID < PACKET_ID_LIMIT ? playPacketHandlers()[packetID] : nullptr;
+    if (!handler) {
+        // Ignored without logging, the per-packet statistics count them by ID
+        return;
     }
+
+    PlayPacketContext context{connection, client, packetData, reader, index, player, registryManager};
+    handler(context);
 }
 
-void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& newPlayer, const RegistryManager& registryManager) {
+void enterPlayState(const std::shared_ptr<ClientConnection>& connection) {
+    ClientConnection& client = *connection;
+    const std::shared_ptr<Player>& newPlayer = client.player;
+
     // Send Join Game packet
     sendJoinGamePacket(client, newPlayer->entityID);
 
@@ -1459,43 +1441,18 @@ void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& ne
 
     // Send Player Info Update to all existing clients about the new player
     std::vector<std::shared_ptr<Player>> newPlayerInfo = {newPlayer};
-    {
-        std::lock_guard lock(connectedClientsMutex);
-        for (auto& [uuid, existingClient] : connectedClients) {
-            if (uuid != newPlayer->uuidString) {
-                sendPlayerInfoUpdate(*existingClient, newPlayerInfo, 0x09); // 0x01: Add Player, 0x08: Update Listed
-            }
-        }
-    }
+    sendPlayerInfoUpdate(newPlayerInfo, 0x09, newPlayer->uuidString); // 0x01: Add Player, 0x08: Update Listed
 
     // Send Player Info Update to the new player about themselves
     sendPlayerInfoUpdate(client, newPlayerInfo, 0x09); // 0x01: Add Player, 0x08: Update Listed
 
-    // Send Spawn Entity packets
-    // Send to the new client about existing players
-    for (const auto &entity: existingEntities | std::views::values) {
-        if (entity->uuidString != newPlayer->uuidString && entity->type == EntityType::Player) {
-            sendSpawnEntityPacket(client, entity);
-        }
-    }
-
-    // Send to existing clients about the new player
     {
         std::lock_guard lock(connectedClientsMutex);
-        for (auto& [uuid, existingClient] : connectedClients) {
-            if (uuid != newPlayer->uuidString) {
-                sendSpawnEntityPacket(*existingClient, newPlayer);
-            }
-        }
+        connectedClients[newPlayer->uuidString] = connection;
     }
-    {
-        std::lock_guard lock(connectedClientsMutex);
-        connectedClients[newPlayer->uuidString] = &client;
-    }
-
 
-    // Start Keep Alive loop in a separate thread
-    std::thread keepAliveLoop(startKeepAliveLoop, std::ref(client));
+    // Keep Alive packets are sent by the I/O thread every 15 seconds
+    client.lastKeepAlive = std::chrono::steady_clock::now();
 
     // Send Game Event: Start waiting for level chunks
     // According to the protocol, the value depends on the event
@@ -1506,122 +1463,9 @@ void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& ne
     // Send Set Center Chunk packet with initial chunk coordinates
     sendSetCenterChunkPacket(client, newPlayer->currentChunkX, newPlayer->currentChunkZ);
 
-    // Send Chunk Data Packets
-    // Determine which chunks to send based on view distance
-    int viewDistance = serverConfig.viewDistance; // TODO: Send to player
     int centerChunkX = newPlayer->currentChunkX;
     int centerChunkZ = newPlayer->currentChunkZ;
 
-
-    // TODO: Use getChunksInView
-    // Load and send chunks within view distance
-    auto sendChunks = [&](int centerX, int centerZ, const std::shared_ptr<Player>& player) {
-        // Measure time
-        auto startTime = std::chrono::steady_clock::now();
-
-        // Define the chunks to load and already loaded
-        std::vector<ChunkCoordinates> chunksToLoad;
-        std::vector<ChunkCoordinates> chunksAlreadyLoaded; {
-            int chunkCount = 0;
-            std::lock_guard lock(chunkMapMutex);
-            for (int dx = -viewDistance; dx <= viewDistance; ++dx) {
-                for (int dz = -viewDistance; dz <= viewDistance; ++dz) {
-                    // Skip the current chunk if needed
-                    chunkCount++;
-                    if (dx == 0 && dz == 0) continue;
-
-                    int chunkX = centerX + dx;
-                    int chunkZ = centerZ + dz;
-                    ChunkCoordinates coords{chunkX, chunkZ};
-                    auto it = globalChunkMap.find(coords);
-                    if (it != globalChunkMap.end()) {
-                        chunksAlreadyLoaded.emplace_back(coords);
-                    } else {
-                        chunksToLoad.emplace_back(coords);
-                    }
-                }
-            }
-        }
-
-        // Vector to hold futures for loaded chunks
-        std::vector<std::future<std::shared_ptr<Chunk>>> loadFutures;
-        loadFutures.reserve(chunksToLoad.size());
-
-        // Enqueue load/generate tasks
-        for (const auto& coords : chunksToLoad) {
-            loadFutures.emplace_back(
-                threadPool.enqueue([coords]() -> std::shared_ptr<Chunk> {
-                    // Attempt to load the chunk from disk
-                    auto loadedChunk = loadChunkFromDisk(coords.chunkX, coords.chunkZ);
-                    if (!loadedChunk) {
-                        // Generate the chunk if loading failed
-                        if (serverConfig.worldType == "flat") {
-                            FlatWorldSettings settings = flatWorldPresets[serverConfig.flatWorldPreset];
-                            int highestY;
-                            loadedChunk = generateFlatChunk(settings, coords.chunkX, coords.chunkZ, highestY);
-                        }
-                    }
-                    return loadedChunk;
-                })
-            );
-        }
-
-        // Vector to hold chunks to send (already loaded and newly loaded)
-        std::vector<std::shared_ptr<Chunk>> chunksToSend;
-        chunksToSend.reserve(chunksAlreadyLoaded.size() + chunksToLoad.size());
-
-        // Collect already loaded chunks
-        {
-            std::lock_guard lock(chunkMapMutex);
-            for (const auto& coords : chunksAlreadyLoaded) {
-                auto it = globalChunkMap.find(coords);
-                if (it != globalChunkMap.end()) {
-                    chunksToSend.emplace_back(it->second);
-                }
-            }
-        }
-
-        // Collect loaded/generated chunks and update globalChunkMap
-        for (size_t i = 0; i < loadFutures.size(); ++i) {
-            if (std::shared_ptr<Chunk> chunk = loadFutures[i].get()) {
-                {
-                    std::lock_guard lock(chunkMapMutex);
-                    globalChunkMap[chunksToLoad[i]] = chunk;
-                }
-                chunksToSend.emplace_back(chunk);
-            }
-        }
-
-        // Vector to hold futures for sending chunks
-        std::vector<std::future<void>> sendFutures;
-        sendFutures.reserve(chunksToSend.size());
-
-        // Enqueue send tasks
-        for (const auto& chunk : chunksToSend) {
-            sendFutures.emplace_back(
-                threadPool.enqueue([chunk, &client]() -> void {
-                    sendChunkDataToPlayer(client, chunk);
-                })
-            );
-        }
-
-        for (const auto& chunk : chunksToSend) {
-            player->loadedChunks.insert({chunk->chunkX, chunk->chunkZ});
-        }
-
-        // Wait for all sends to complete
-        for (auto& future : sendFutures) {
-            future.get();
-        }
-
-        auto chunkCreationTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - startTime
-        ).count();
-
-        logMessage("Loaded and Sent " + std::to_string(chunksToSend.size()) + " chunks in " + std::to_string(chunkCreationTime) + " ms", LOG_DEBUG);
-
-    };
-
     // Initialize the world border
     worldBorder.initialize(serverConfig.worldBorder);
     sendInitializeWorldBorder(client, worldBorder);
@@ -1629,324 +1473,156 @@ void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& ne
     // Send current chunk to the player
     sendCurrentChunkToPlayer(client, centerChunkX, centerChunkZ);
 
-    updatePlayerChunkView(newPlayer, -1, -1, centerChunkX, centerChunkZ);
-
-    // Asynchronously send chunks to avoid blocking
-    std::thread(sendChunks, newPlayer->currentChunkX, newPlayer->currentChunkZ, newPlayer).detach();
-
-    // Send Resource Packs
-    sendResourcePacks(client);
-
-    // Receive and handle client packets
-    try {
-        while (true) {
-            std::vector<uint8_t> packetData;
-            if (!readPacket(client, packetData)) {
-                disconnectClient(newPlayer, "Player disconnected", false);
-                break;
-            }
-
-            // Process incoming packets (e.g., Keep Alive Response)
-            handleClientPacket(client, packetData, newPlayer, registryManager);
-
-            std::this_thread::sleep_for(std::chrono::nanoseconds(100)); // Avoid high CPU usage
-        }
-    } catch (const std::exception& e) {
-        disconnectClient(newPlayer, "Player disconnected", false);
-        logMessage("Client disconnected with error: " + std::string(e.what()), LOG_ERROR);
+    {
+        std::lock_guard lock(newPlayer->loadedChunksMutex);
+        newPlayer->loadedChunks.insert({centerChunkX, centerChunkZ});
     }
 
-    // Clean up
-    keepAliveLoop.join();
-}
+    int viewDistance = getChunkViewDistance(*newPlayer);
+    updatePlayerChunkView(newPlayer, centerChunkX, centerChunkZ, viewDistance);
 
-bool waitForAcknowledgeFinishConfiguration(const ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    if (!readPacket(client, packetData)) {
-        return false;
-    }
+    // Spawn the entities around the new player, and the new player for the players around it
+    entityTracker.updatePlayer(newPlayer);
+    entityTracker.updateEntity(newPlayer);
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != ACKNOWLEDGE_FINISH_CONFIGURATION) {
-        // Expected Acknowledge Finish Configuration packet
-        std::stringstream stringstream;
-        stringstream << "Expected Acknowledge Finish Configuration packet. Instead received: 0x" << std::hex << packetID << std::dec;
-        std::string formattedMessage = stringstream.str();
-        logMessage(formattedMessage, LOG_ERROR);
-        return false;
+    // The rest of the view is sent in batches by the tick thread
+    {
+        std::lock_guard lock(newPlayer->loadedChunksMutex);
+        queueChunksInView(newPlayer, viewDistance);
     }
 
-    // No fields to parse
+    // Send Resource Packs
+    sendResourcePacks(client);}
 
-    return true;
-}
+bool checkClientTimers(ClientConnection& client, std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point& nextCheck) {
+    constexpr auto CONNECTION_TIMEOUT = std::chrono::seconds(30);
+    constexpr auto KEEP_ALIVE_INTERVAL = std::chrono::seconds(15);
+    constexpr auto OUTBOUND_STALL_TIMEOUT = std::chrono::seconds(10);
 
-bool waitForClientKnownPacks(const ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    if (!readPacket(client, packetData)) {
+    // Nothing is expected from the client while the shared secret is decrypted or the session server is queried
+    bool waitingOnServer = client.loginStage == LoginStage::Decrypting || client.loginStage == LoginStage::Authenticating;
+    if (!waitingOnServer && now - client.lastActivity > CONNECTION_TIMEOUT) {
+        logMessage("Connection timed out: " + getClientIPAddress(client), LOG_DEBUG);
         return false;
     }
+    nextCheck = (waitingOnServer ? now : client.lastActivity) + CONNECTION_TIMEOUT;
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != SERVERBOUND_KNOWN_PACKS) {
-        // Expected Known Packs packet
-        return false;
+    // A client that can't keep up with its outbound queue is dropped
+    if (client.outboundBytes > static_cast<size_t>(serverConfig.outboundHighWaterMark)) {
+        if (client.outboundStalledSince == std::chrono::steady_clock::time_point{}) {
+            client.outboundStalledSince = now;
+        } else if (now - client.outboundStalledSince > OUTBOUND_STALL_TIMEOUT) {
+            logMessage("Outbound queue of " + getClientIPAddress(client) + " stalled at " + std::to_string(client.outboundBytes) + " bytes", LOG_WARNING);
+            return false;
+        }
+        nextCheck = std::min(nextCheck, client.outboundStalledSince + OUTBOUND_STALL_TIMEOUT);
+    } else {
+        client.outboundStalledSince = {};
     }
-    size_t packCount = parseVarInt(packetData, index);
-
-    return true;
-}
 
-bool waitForClientPluginMessage(const ClientConnection & client, Player& player) {
-    std::vector<uint8_t> packetData;
-    if (!readPacketTimeout(client, packetData, 2, false)) {
-        return false;
+    if (client.state != ClientState::Play && client.state != ClientState::AwaitingTeleportConfirm) {
+        // Logins are short, checking them every second keeps the first keep-alive on time
+        nextCheck = std::min(nextCheck, now + std::chrono::seconds(1));
+        return true;
     }
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != LOGIN_PLUGIN_RESPONSE) {
-        // Expected Plugin Message packet
-        return false;
+    // A client that keeps moving but never answers keep-alives is dropped as well.
+    // No new keep-alive goes out while one is outstanding, so the timeout counts from the first unanswered one.
+    if (client.keepAliveSentAt != std::chrono::steady_clock::time_point{}) {
+        if (now - client.keepAliveSentAt > CONNECTION_TIMEOUT) {
+            logMessage("Keep Alive timed out: " + getClientIPAddress(client), LOG_DEBUG);
+            return false;
+        }
+        nextCheck = std::min(nextCheck, client.keepAliveSentAt + CONNECTION_TIMEOUT);
+        // Looked at again when the next one would be due, and every second after that until it is answered
+        nextCheck = std::min(nextCheck, std::max(client.lastKeepAlive + KEEP_ALIVE_INTERVAL, now + std::chrono::seconds(1)));
+        return true;
     }
 
-    handlePluginMessage(client, packetData, index, player);
-
+    // Send Keep Alive packets every 15 seconds, without waiting for the tick flush
+    if (now - client.lastKeepAlive >= KEEP_ALIVE_INTERVAL) {
+        client.lastKeepAlive = now;
+        if (!sendKeepAlivePacket(client) || !flushPackets(client)) {
+            return false;
+        }
+    }
+    nextCheck = std::min(nextCheck, client.lastKeepAlive + KEEP_ALIVE_INTERVAL);
     return true;
 }
 
-bool waitforClientInfo(const ClientConnection & client, Player& player) {
-    std::vector<uint8_t> packetData;
-    if (!readPacket(client, packetData)) {
-        return false;
-    }
-
+bool handleConfigurationPacket(const std::shared_ptr<ClientConnection>& connection, std::span<const uint8_t> packetData) {
+    ClientConnection& client = *connection;
+    Player& player = *client.player;
     size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != CLIENT_INFORMATION) {
-        // Expected Client Info packet
-        return false;
-    }
-
-    return handleClientInformation(player, packetData, index);
-}
 
-bool handleConfigurationState(ClientConnection& client, RegistryManager& registryManager, Player& player) {
-
-    waitForClientPluginMessage(client, player);
-
-    if (!waitforClientInfo(client, player)) {
-        // Handle error or disconnection
-        return false;
-    }
-
-    sendServerPluginMessages(client);
-
-    sendFeatureFlags(client, {"minecraft:vanilla"});
+    switch (int32_t packetID = parseVarInt(packetData, index)) {
+        case CLIENT_INFORMATION: // Client Information
+            if (!handleClientInformation(player, packetData, index)) {
+                return false;
+            }
 
-    sendKnownPacksPacket(client);
+            sendServerPluginMessages(client);
 
-    if (!waitForClientKnownPacks(client)) {
-        // Handle error or disconnection
-        return false;
-    }
+            sendFeatureFlags(client, {"minecraft:vanilla"});
 
-    // Send Registry Data packet
-    sendRegistryDataPacket(client, registryManager);
+            sendKnownPacksPacket(client);
+            break;
+        case LOGIN_PLUGIN_RESPONSE: // Serverbound Plugin Message
+            handlePluginMessage(client, packetData, index, player);
+            break;
+        case SERVERBOUND_KNOWN_PACKS: // Known Packs
+            // Send Registry Data packet
+            sendRegistryDataPacket(client);
 
-    // Update tags
-    sendUpdateTagsPacket(client);
+            // Update tags
+            sendUpdateTagsPacket(client);
 
-    // Send server links
-    sendServerLinksPacket(client);
+            // Send server links
+            sendServerLinksPacket(client);
 
-    // Send Finish Configuration packet
-    sendFinishConfigurationPacket(client);
+            // Send Finish Configuration packet
+            sendFinishConfigurationPacket(client);
+            break;
+        case ACKNOWLEDGE_FINISH_CONFIGURATION: // Acknowledge Finish Configuration
+            sendTranslatedChatMessage("multiplayer.player.joined", false, "yellow", nullptr, true, player.name);
 
-    // Wait for Acknowledge Finish Configuration from the client
-    if (!waitForAcknowledgeFinishConfiguration(client)) {
-        logMessage("Failed to receive Acknowledge Finish Configuration packet", LOG_ERROR);
-        return false;
+            // Now in Play state
+            client.state = ClientState::Play;
+            enterPlayState(connection);
+            break;
+        default:
+            std::stringstream stringstream;
+            stringstream << "Received unexpected configuration packet ID: 0x" << std::hex << packetID << std::dec;
+            logMessage(stringstream.str(), LOG_WARNING);
+            break;
     }
-
     return true;
 }
 
-void handleLoginRequest(ClientConnection& client, RegistryManager& registryManager) {
-    // Read Login Start packet
-    std::vector<uint8_t> packetData;
-    if (!readUnencryptedPacket(client, packetData)) {
-        return;
-    }
-
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != 0x00) {
-        return;
-    }
-
-    std::string playerName = parseString(packetData, index);
-    // Set UUID for the new player
-    std::vector<uint8_t> uuidBytesVec = parseBytes(packetData, index, 16);
-    // Convert to std::array
-    std::array<uint8_t, 16> uuidBytes = { };
-    std::ranges::copy(uuidBytesVec, uuidBytes.begin());
-    std::string playerUUID = bytesToUUIDString(uuidBytes);
-    // Remove '-' characters from UUID string
-    std::erase(playerUUID, '-');
-    uuidBytes = stringUUIDToBytes(playerUUID);
-
-    if (playerUUID.empty()) {
-        playerUUID = fetchPlayerUUID(playerName);
-        if (playerUUID.empty()) {
-            logMessage("Failed to fetch player UUID for: " + playerName, LOG_ERROR);
-            return;
-        }
-        uuidBytes = stringUUIDToBytes(playerUUID);
-    }
-
-     // ************ Encryption Start ************
-    if (serverConfig.enableEncryption) {
-        // Step 1: Generate a random verify token (16 bytes recommended)
-        std::array<uint8_t, 16> verifyToken{};
-        if (RAND_bytes(verifyToken.data(), verifyToken.size()) != 1) {
-            logMessage("Failed to generate verify token", LOG_ERROR);
-            return;
-        }
-
-        // Step 2: Get server's public key in DER format
-        std::vector<uint8_t> serverPublicKeyDER = registryManager.getRSAKeyPair().getPublicKeyDER();
+bool finishLogin(const std::shared_ptr<ClientConnection>& connection, bool authSuccess, const std::string& authenticatedName, const std::string& playerUUID, const std::pair<std::string, std::string>& texturesPair) {
+    ClientConnection& client = *connection;
+    const std::string& playerName = client.loginName;
+    const std::array<uint8_t, 16>& uuidBytes = client.loginUUID;
 
-        // Step 3: Construct Encryption Request packet
-        std::vector<uint8_t> encryptionRequestPacket;
-
-        // Packet ID for Encryption Request
-        writeVarInt(encryptionRequestPacket, 0x01);
-
-        // Server ID (empty string for modern versions)
-        writeString(encryptionRequestPacket, serverConfig.serverId);
-
-        // Public Key Length and Public Key
-        writeVarInt(encryptionRequestPacket, static_cast<int32_t>(serverPublicKeyDER.size()));
-        encryptionRequestPacket.insert(encryptionRequestPacket.end(), serverPublicKeyDER.begin(), serverPublicKeyDER.end());
-
-        // Verify Token Length and Verify Token
-        writeVarInt(encryptionRequestPacket, verifyToken.size());
-        encryptionRequestPacket.insert(encryptionRequestPacket.end(), verifyToken.begin(), verifyToken.end());
-
-        // Should authenticate (boolean)
-        writeByte(encryptionRequestPacket, serverConfig.onlineMode);
-
-        // Send Encryption Request packet
-        if (!sendUnencryptedPacket(client, encryptionRequestPacket)) {
-            logMessage("Failed to send Encryption Request packet", LOG_ERROR);
-            return;
-        }
-
-        // Step 4: Receive Encryption Response packet
-        std::vector<uint8_t> encryptionResponseData;
-        if (!readUnencryptedPacket(client, encryptionResponseData)) {
-            logMessage("Failed to read Encryption Response packet", LOG_ERROR);
-            return;
-        }
-
-        size_t respIndex = 0;
-        int32_t respPacketID = parseVarInt(encryptionResponseData, respIndex);
-        if (respPacketID != 0x01) {
-            logMessage("Invalid Encryption Response packet ID: " + std::to_string(respPacketID) + " (expected 0x01)", LOG_ERROR);
-            return;
-        }
-
-        // Parse Encryption Response
-        // Encrypted Shared Secret
-        int32_t encryptedSharedSecretLength = parseVarInt(encryptionResponseData, respIndex);
-        std::vector<uint8_t> encryptedSharedSecret = parseBytes(encryptionResponseData, respIndex, encryptedSharedSecretLength);
-
-        // Encrypted Verify Token
-        int32_t encryptedVerifyTokenLength = parseVarInt(encryptionResponseData, respIndex);
-        std::vector<uint8_t> encryptedVerifyToken = parseBytes(encryptionResponseData, respIndex, encryptedVerifyTokenLength);
-
-        // Step 5: Decrypt Shared Secret and Verify Token using server's private key
-        std::vector<uint8_t> decryptedSharedSecret = registryManager.getRSAKeyPair().decrypt(encryptedSharedSecret);
-        std::vector<uint8_t> decryptedVerifyToken = registryManager.getRSAKeyPair().decrypt(encryptedVerifyToken);
-
-        // Step 6: Verify that the decrypted verify token matches the original
-        if (decryptedVerifyToken.size() != verifyToken.size() ||
-            std::memcmp(decryptedVerifyToken.data(), verifyToken.data(), verifyToken.size()) != 0) {
-            logMessage("Verify token mismatch", LOG_ERROR);
-            return;
-            }
-
-        // Step 7: Store the shared secret
-        if (decryptedSharedSecret.size() < 16) { // AES-128 requires at least 16 bytes
-            logMessage("Invalid shared secret size", LOG_ERROR);
-            return;
-        }
-        std::copy_n(decryptedSharedSecret.begin(), 16, client.sharedSecret.begin());
-
-        // Step 8: Initialize AES/CFB8 encryption and decryption contexts
-        client.encryptCtx = EVP_CIPHER_CTX_new();
-        client.decryptCtx = EVP_CIPHER_CTX_new();
-        if (!client.encryptCtx || !client.decryptCtx) {
-            logMessage("Failed to create AES cipher contexts", LOG_ERROR);
-            sendDisconnectionPacket(client, "Failed to create AES cipher contexts");
-            return;
-        }
-
-        // Initialize encryption context (AES-128-CFB8)
-        if (EVP_EncryptInit_ex(client.encryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
-            logMessage("Failed to initialize AES encryption context", LOG_ERROR);
-            sendDisconnectionPacket(client, "Failed to initialize AES encryption context");
-            return;
-        }
-
-        // Initialize decryption context (AES-128-CFB8)
-        if (EVP_DecryptInit_ex(client.decryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
-            logMessage("Failed to initialize AES decryption context", LOG_ERROR);
-            sendDisconnectionPacket(client, "Failed to initialize AES decryption context");
-            return;
-        }
-    }
-
-    // ************ Encryption Setup Complete ************
-
-    // ************ Step 3: Online Mode Authentication ************
-    std::pair<std::string, std::string> texturesPair;
     if (serverConfig.onlineMode) {
-        // Step 3.1: Compute Server Hash
-        std::string serverId = serverConfig.serverId; // Ensure you have initialized server_id
-        std::string serverHash = computeServerHash(serverId, client.sharedSecret, registryManager.getRSAKeyPair().getPublicKeyDER());
-
-        // Step 3.2: Get Client's IP Address
-        std::string clientIP = getClientIPAddress(client);
-
-        // Step 3.3: Authenticate with Mojang
-        std::string authenticatedUUID;
-        std::string authenticatedName;
-        bool authSuccess = authenticatePlayer(playerName, serverHash, clientIP, authenticatedUUID, authenticatedName, texturesPair);
-
         if (!authSuccess) {
             sendDisconnectionPacket(client, "Authentication with Mojang failed. Disconnecting.");
-            return;
+            return false;
         }
 
         // Verify that the authenticatedName matches the provided playerName
         if (authenticatedName != playerName) {
             logMessage("Player name mismatch: " + authenticatedName + " != " + playerName, LOG_ERROR);
             sendDisconnectionPacket(client, "Player name mismatch. Disconnecting.");
-            return;
+            return false;
         }
 
-        playerUUID = authenticatedUUID;
-        logMessage("Player authenticated: " + authenticatedName + " (" + authenticatedUUID + ")", LOG_DEBUG);
+        logMessage("Player authenticated: " + authenticatedName + " (" + playerUUID + ")", LOG_DEBUG);
     } else {
         // Offline Mode: Use the client-provided UUID
         logMessage("Offline Mode: Using client-provided UUID: " + playerUUID, LOG_DEBUG);
     }
 
-
     if (serverConfig.enableCompression) {
         sendSetCompressionPacket(client, serverConfig.compressionThreshold);
         client.compressionEnabled = true;
@@ -1962,18 +1638,14 @@ void handleLoginRequest(ClientConnection& client, RegistryManager& registryManag
     newPlayer->listed = true;
     newPlayer->ping = -1; // Unknown initially
     newPlayer->setClient(&client);
-    if (texturesPair.first.empty() || texturesPair.second.empty()) {
-        texturesPair = fetchPlayerSkin(newPlayer->uuidString);
-        if (!texturesPair.first.empty() && !texturesPair.second.empty()) {
-            newPlayer->properties["textures"] = { texturesPair.first, texturesPair.second };
-        } else {
-            // Assign a default skin if fetching fails
-            std::string defaultSkin = "eyJ0aW1lc3RhbXAiOjE1OTA0ODEyMDAwMDAsInByb2ZpbGVJZCI6InV1aWQiLCJwcm9maWxlTmFtZSI6InBsYXllck5hbWUiLCJ0ZXh0dXJlcyI6eyJTS0lOIjp7InVybCI6Imh0dHA6Ly90ZXh0dXJlcy5taW5lY3JhZnQubmV0L3RleHR1cmUvczg2YzIyYjYyMmY2Y2E3ZTJmZjhkNTYyN2FkNDMxMDgyMjYyYzE5ZTM5MjMxYjI1YjczNGNiZDI0N2EwMjA4ZCJ9fX0=";
-            newPlayer->properties["textures"] = { defaultSkin, "" };
-        }
-    } else {
+    if (!texturesPair.first.empty() && !texturesPair.second.empty()) {
         newPlayer->properties["textures"] = { texturesPair.first, texturesPair.second };
+    } else {
+        // Assign a default skin if fetching fails
+        std::string defaultSkin = "eyJ0aW1lc3RhbXAiOjE1OTA0ODEyMDAwMDAsInByb2ZpbGVJZCI6InV1aWQiLCJwcm9maWxlTmFtZSI6InBsYXllck5hbWUiLCJ0ZXh0dXJlcyI6eyJTS0lOIjp7InVybCI6Imh0dHA6Ly90ZXh0dXJlcy5taW5lY3JhZnQubmV0L3RleHR1cmUvczg2YzIyYjYyMmY2Y2E3ZTJmZjhkNTYyN2FkNDMxMDgyMjYyYzE5ZTM5MjMxYjI1YjczNGNiZDI0N2EwMjA4ZCJ9fX0=";
+        newPlayer->properties["textures"] = { defaultSkin, "" };
     }
+    client.player = newPlayer;
 
     // Add the new player to the global player list
     {
@@ -1984,9 +1656,10 @@ void handleLoginRequest(ClientConnection& client, RegistryManager& registryManag
 
     // Increase player count
     ++playerCount;
+    invalidateStatusResponse();
 
     // Send Login Success packet
-    std::vector<uint8_t> responseData;
+    PacketWriter responseData;
     responseData.push_back(LOGIN_SUCCESS);
 
     // Append UUID (16 bytes)
@@ -2002,93 +1675,310 @@ void handleLoginRequest(ClientConnection& client, RegistryManager& registryManag
     responseData.push_back(0x00); // TODO: Only in versions before 1.21.2 and 1.20.5+
 
     // Build and send the packet
-    sendPacket(client, responseData);
+    sendPacket(client, std::move(responseData));
 
     // ************ Wait for Login Acknowledged Packet ************
-    std::vector<uint8_t> ackPacket;
-    if (!readPacket(client, ackPacket)) {
-        logMessage("Failed to read Login Acknowledged packet", LOG_ERROR);
+    client.loginStage = LoginStage::AwaitingAcknowledge;
+    client.lastActivity = std::chrono::steady_clock::now();
+    return true;
+}
+
+// Continue the login on the connection's I/O thread once the session server answered
+static void resumeLogin(const std::shared_ptr<ClientConnection>& connection, bool authSuccess, const std::string& authenticatedName, const std::string& authenticatedUUID, const std::pair<std::string, std::string>& texturesPair) {
+    connectionReactor.post(connection, [connection, authSuccess, authenticatedName, authenticatedUUID, texturesPair]() {
+        if (!finishLogin(connection, authSuccess, authenticatedName, authenticatedUUID, texturesPair)) {
+            shutdownConnection(*connection);
+        }
+    });
+}
+
+void authenticateLogin(const std::shared_ptr<ClientConnection>& connection) {
+    ClientConnection& client = *connection;
+    client.loginStage = LoginStage::Authenticating;
+
+    std::string playerUUID = bytesToUUIDString(client.loginUUID);
+    std::erase(playerUUID, '-');
+
+    // ************ Step 3: Online Mode Authentication ************
+    if (!serverConfig.onlineMode) {
+        // Only the skin is looked up
+        fetchPlayerSkinAsync(playerUUID, [connection, playerUUID](const std::pair<std::string, std::string>& texturesPair) {
+            resumeLogin(connection, true, "", playerUUID, texturesPair);
+        });
         return;
     }
 
-    size_t ackIndex = 0;
-    int32_t ackPacketID = parseVarInt(ackPacket, ackIndex);
-    if (ackPacketID != LOGIN_ACKNOWLEDGE) {
-        logMessage("Expected Login Acknowledged packet (ID 0x03), but received packet ID: " + std::to_string(ackPacketID), LOG_ERROR);
-        return;
+    // Step 3.1: Compute Server Hash
+    std::string serverHash = computeServerHash(serverConfig.serverId, client.sharedSecret, RegistryManager::getInstance().getRSAKeyPair().getPublicKeyDER());
+
+    // Step 3.2: Authenticate with Mojang, without blocking the I/O thread
+    authenticatePlayerAsync(client.loginName, serverHash, [connection](const SessionProfile& profile) {
+        resumeLogin(connection, profile.authenticated, profile.name, profile.uuid, profile.textures);
+    });
+}
+
+bool handleLoginStart(const std::shared_ptr<ClientConnection>& connection, std::span<const uint8_t> packetData, size_t index) {
+    ClientConnection& client = *connection;
+    std::string playerName = parseString(packetData, index);
+    // Set UUID for the new player
+    std::vector<uint8_t> uuidBytesVec = parseBytes(packetData, index, 16);
+    // Convert to std::array
+    std::array<uint8_t, 16> uuidBytes = { };
+    std::ranges::copy(uuidBytesVec, uuidBytes.begin());
+    std::string playerUUID = bytesToUUIDString(uuidBytes);
+    // Remove '-' characters from UUID string
+    std::erase(playerUUID, '-');
+    uuidBytes = stringUUIDToBytes(playerUUID);
+
+    client.loginName = playerName;
+    client.loginUUID = uuidBytes;
+
+     // ************ Encryption Start ************
+    if (!serverConfig.enableEncryption) {
+        authenticateLogin(connection);
+        return true;
     }
 
-    // Now in Configuration state
-    client.state = ClientState::Configuration;
-    if(!handleConfigurationState(client, registryManager, *newPlayer)) {
-        return;
+    // Step 1: Generate a random verify token (16 bytes recommended)
+    if (RAND_bytes(client.verifyToken.data(), client.verifyToken.size()) != 1) {
+        logMessage("Failed to generate verify token", LOG_ERROR);
+        return false;
     }
 
-    sendTranslatedChatMessage("multiplayer.player.joined", false, "yellow", nullptr, true, newPlayer->name);
+    // Step 2: Get server's public key in DER format
+    const std::vector<uint8_t>& serverPublicKeyDER = RegistryManager::getInstance().getRSAKeyPair().getPublicKeyDER();
 
-    // Now in Play state
-    client.state = ClientState::Play;
-    handlePlayState(client, newPlayer, registryManager);
+    // Step 3: Construct Encryption Request packet
+    PacketWriter encryptionRequestPacket;
+
+    // Packet ID for Encryption Request
+    writeVarInt(encryptionRequestPacket, 0x01);
+
+    // Server ID (empty string for modern versions)
+    writeString(encryptionRequestPacket, serverConfig.serverId);
+
+    // Public Key Length and Public Key
+    writeVarInt(encryptionRequestPacket, static_cast<int32_t>(serverPublicKeyDER.size()));
+    encryptionRequestPacket.insert(encryptionRequestPacket.end(), serverPublicKeyDER.begin(), serverPublicKeyDER.end());
+
+    // Verify Token Length and Verify Token
+    writeVarInt(encryptionRequestPacket, client.verifyToken.size());
+    encryptionRequestPacket.insert(encryptionRequestPacket.end(), client.verifyToken.begin(), client.verifyToken.end());
+
+    // Should authenticate (boolean)
+    writeByte(encryptionRequestPacket, serverConfig.onlineMode);
+
+    // Send Encryption Request packet
+    if (!sendUnencryptedPacket(client, std::move(encryptionRequestPacket))) {
+        logMessage("Failed to send Encryption Request packet", LOG_ERROR);
+        return false;
+    }
+
+    // Step 4: Wait for the Encryption Response packet
+    client.loginStage = LoginStage::AwaitingEncryptionResponse;
+    return true;
 }
 
-void handleClient(SocketType clientSocket) {
-    ClientConnection client;
-    client.socket = clientSocket;
-    client.state = ClientState::Handshake;
-
-    // Set a timeout for the socket
-#ifdef _WIN32
-    DWORD timeout = 5000; // 5 seconds
-    setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&timeout), sizeof(timeout));
-#else
-    struct timeval tv;
-    tv.tv_sec = 5;
-    tv.tv_usec = 0;
-    setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof(tv));
-#endif
-
-    try {
-        // Read initial packet (Handshake)
-        std::vector<uint8_t> packetData;
-        if (!readUnencryptedPacket(client, packetData)) {
-            // Close socket and return
-            return;
+bool finishEncryption(const std::shared_ptr<ClientConnection>& connection, const std::vector<uint8_t>& decryptedSharedSecret, const std::vector<uint8_t>& decryptedVerifyToken) {
+    ClientConnection& client = *connection;
+
+    // Step 6: Verify that the decrypted verify token matches the original
+    if (decryptedVerifyToken.size() != client.verifyToken.size() ||
+        std::memcmp(decryptedVerifyToken.data(), client.verifyToken.data(), client.verifyToken.size()) != 0) {
+        logMessage("Verify token mismatch", LOG_ERROR);
+        return false;
+    }
+
+    // Step 7: Store the shared secret
+    if (decryptedSharedSecret.size() < 16) { // AES-128 requires at least 16 bytes
+        logMessage("Invalid shared secret size", LOG_ERROR);
+        return false;
+    }
+    std::copy_n(decryptedSharedSecret.begin(), 16, client.sharedSecret.begin());
+
+    // Step 8: Initialize AES/CFB8 encryption and decryption contexts
+    client.encryptCtx = EVP_CIPHER_CTX_new();
+    client.decryptCtx = EVP_CIPHER_CTX_new();
+    if (!client.encryptCtx || !client.decryptCtx) {
+        logMessage("Failed to create AES cipher contexts", LOG_ERROR);
+        sendDisconnectionPacket(client, "Failed to create AES cipher contexts");
+        return false;
+    }
+
+    // Initialize encryption context (AES-128-CFB8)
+    if (EVP_EncryptInit_ex(client.encryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
+        logMessage("Failed to initialize AES encryption context", LOG_ERROR);
+        sendDisconnectionPacket(client, "Failed to initialize AES encryption context");
+        return false;
+    }
+
+    // Initialize decryption context (AES-128-CFB8)
+    if (EVP_DecryptInit_ex(client.decryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
+        logMessage("Failed to initialize AES decryption context", LOG_ERROR);
+        sendDisconnectionPacket(client, "Failed to initialize AES decryption context");
+        return false;
+    }
+
+    // Anything received after the Encryption Response is already encrypted
+    if (!decryptInbound(client, 0)) {
+        return false;
+    }
+
+    // ************ Encryption Setup Complete ************
+    authenticateLogin(connection);
+    return true;
+}
+
+// Encryption Responses waiting for a crypto thread before new logins are turned away
+constexpr size_t MAX_QUEUED_DECRYPTIONS = 256;
+
+bool handleEncryptionResponse(const std::shared_ptr<ClientConnection>& connection, std::span<const uint8_t> encryptionResponseData, size_t respIndex) {
+    ClientConnection& client = *connection;
+
+    // Parse Encryption Response
+    // Encrypted Shared Secret
+    int32_t encryptedSharedSecretLength = parseVarInt(encryptionResponseData, respIndex);
+    std::vector<uint8_t> encryptedSharedSecret = parseBytes(encryptionResponseData, respIndex, encryptedSharedSecretLength);
+
+    // Encrypted Verify Token
+    int32_t encryptedVerifyTokenLength = parseVarInt(encryptionResponseData, respIndex);
+    std::vector<uint8_t> encryptedVerifyToken = parseBytes(encryptionResponseData, respIndex, encryptedVerifyTokenLength);
+
+    // Bound the RSA work a login storm can queue up
+    if (cryptoPool->queued() >= MAX_QUEUED_DECRYPTIONS) {
+        logMessage("Too many logins in progress, rejecting " + client.loginName, LOG_WARNING);
+        sendDisconnectionPacket(client, "The server is busy, please try again.");
+        return false;
+    }
+
+    // Step 5: Decrypt Shared Secret and Verify Token using server's private key.
+    // Everything the client sends from now on is encrypted, so stop parsing until the shared secret is known.
+    client.loginStage = LoginStage::Decrypting;
+    client.inboundPaused = true;
+    cryptoPool->enqueue([connection, encryptedSharedSecret = std::move(encryptedSharedSecret), encryptedVerifyToken = std::move(encryptedVerifyToken)]() {
+        std::vector<uint8_t> decryptedSharedSecret;
+        std::vector<uint8_t> decryptedVerifyToken;
+        try {
+            const RSAKeyPair& keyPair = RegistryManager::getInstance().getRSAKeyPair();
+            decryptedSharedSecret = keyPair.decrypt(encryptedSharedSecret);
+            decryptedVerifyToken = keyPair.decrypt(encryptedVerifyToken);
+        } catch (const std::exception& e) {
+            logMessage("Failed to decrypt Encryption Response: " + std::string(e.what()), LOG_ERROR);
         }
 
-        size_t index = 0;
-        int32_t packetID = parseVarInt(packetData, index);
-
-        if (packetID == HANDSHAKE) {
-            // Handshake packet
-            int32_t protocolVersion = parseVarInt(packetData, index);
-            std::string serverAddress = parseString(packetData, index);
-            uint16_t serverPort = (packetData[index] << 8) | packetData[index + 1];
-            index += 2;
-            int32_t nextState = parseVarInt(packetData, index);
-
-            if (nextState == 1) {
-                // Status Request
-                handleStatusRequest(client);
-            } else if (nextState == 2) {
-                RegistryManager registryManager;
-                // Login Request
-                handleLoginRequest(client, registryManager);
+        // Continue on the connection's I/O thread
+        connectionReactor.post(connection, [connection, decryptedSharedSecret, decryptedVerifyToken]() {
+            connection->inboundPaused = false;
+            if (!finishEncryption(connection, decryptedSharedSecret, decryptedVerifyToken)) {
+                shutdownConnection(*connection);
             }
-        } else {
-            logMessage("Invalid Handshake packet ID: " + std::to_string(packetID), LOG_ERROR);
-            return;
+        });
+    });
+    return true;
+}
+
+bool handleLoginPacket(const std::shared_ptr<ClientConnection>& connection, std::span<const uint8_t> packetData) {
+    ClientConnection& client = *connection;
+    size_t index = 0;
+    int32_t packetID = parseVarInt(packetData, index);
+
+    switch (client.loginStage) {
+        case LoginStage::AwaitingStart:
+            // Login Start
+            if (packetID != 0x00) {
+                return false;
+            }
+            return handleLoginStart(connection, packetData, index);
+        case LoginStage::AwaitingEncryptionResponse:
+            if (packetID != 0x01) {
+                logMessage("Invalid Encryption Response packet ID: " + std::to_string(packetID) + " (expected 0x01)", LOG_ERROR);
+                return false;
+            }
+            return handleEncryptionResponse(connection, packetData, index);
+        case LoginStage::Decrypting:
+        case LoginStage::Authenticating:
+            // The client has nothing to send until Login Success
+            return true;
+        case LoginStage::AwaitingAcknowledge:
+            if (packetID != LOGIN_ACKNOWLEDGE) {
+                logMessage("Expected Login Acknowledged packet (ID 0x03), but received packet ID: " + std::to_string(packetID), LOG_ERROR);
+                return false;
+            }
+            // Now in Configuration state
+            client.state = ClientState::Configuration;
+            return true;
+    }
+    return false;
+}
+
+bool handleHandshake(ClientConnection& client, std::span<const uint8_t> packetData) {
+    size_t index = 0;
+    int32_t packetID = parseVarInt(packetData, index);
+    if (packetID != HANDSHAKE) {
+        logMessage("Invalid Handshake packet ID: " + std::to_string(packetID), LOG_ERROR);
+        return false;
+    }
+
+    // Handshake packet
+    int32_t protocolVersion = parseVarInt(packetData, index);
+    std::string serverAddress = parseString(packetData, index);
+    uint16_t serverPort = parseByte(packetData, index) << 8;
+    serverPort |= parseByte(packetData, index);
+    int32_t nextState = parseVarInt(packetData, index);
+
+    if (nextState == 1) {
+        // Status Request
+        std::string address = getClientIPAddress(client);
+        if (!allowStatusRequest(address)) {
+            logMessage("Too many status requests from " + address, LOG_DEBUG);
+            return false;
         }
-    } catch (const std::exception& e) {
-        logMessage("Client disconnected with error: " + std::string(e.what()), LOG_ERROR);
-        sendDisconnectionPacket(client, "Disconnected with error");
+        client.state = ClientState::Status;
+        return true;
+    }
+    if (nextState == 2) {
+        // Login Request
+        client.state = ClientState::Login;
+        return true;
+    }
+    return false;
+}
+
+static bool dispatchIncomingPacket(const std::shared_ptr<ClientConnection>& client, std::span<const uint8_t> packetData) {
+    switch (client->state) {
+        case ClientState::Handshake:
+            return handleHandshake(*client, packetData);
+        case ClientState::Status:
+            return handleStatusPacket(*client, packetData);
+        case ClientState::Login:
+            return handleLoginPacket(client, packetData);
+        case ClientState::Configuration:
+            return handleConfigurationPacket(client, packetData);
+        case ClientState::Play:
+        case ClientState::AwaitingTeleportConfirm:
+            handleClientPacket(client, packetData, client->player, RegistryManager::getInstance());
+            return true;
     }
+    return false;
+}
 
-    // Close socket
-#ifdef _WIN32
-    closesocket(clientSocket);
-#else
-    close(clientSocket);
-#endif
+bool handleIncomingPacket(const std::shared_ptr<ClientConnection>& client, std::span<const uint8_t> packetData) {
+    // Handlers may switch the state, so the packet is counted under the state it arrived in
+    ClientState state = client->state;
+    int32_t packetID = packetData.empty() ? -1 : packetData[0];
+    auto start = std::chrono::steady_clock::now();
+    bool keepOpen = dispatchIncomingPacket(client, packetData);
+    recordPacket(PacketDirection::Serverbound, state, packetID, packetData.size(), std::chrono::steady_clock::now() - start);
+    return keepOpen;
 }
 
+void handleClientClosed(const std::shared_ptr<ClientConnection>& client) {
+    if (client->player) {
+        disconnectClient(client->player, "Player disconnected", false);
+    }
+}
 
+ClientConnection::~ClientConnection() {
+    EVP_CIPHER_CTX_free(encryptCtx);
+    EVP_CIPHER_CTX_free(decryptCtx);
+}
@@ -2,6 +2,9 @@
 #define CLIENT_H
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -9,6 +12,7 @@
 #include <openssl/types.h>
 
 #include "network.h"
+#include "utils/ring_buffer.h"
 
 struct Player;
 
@@ -21,12 +25,20 @@ enum class ClientState {
     AwaitingTeleportConfirm,
 };
 
+enum class LoginStage {
+    AwaitingStart,
+    AwaitingEncryptionResponse,
+    Decrypting,
+    Authenticating,
+    AwaitingAcknowledge,
+};
+
 struct ClientConnection {
     SocketType socket;
     ClientState state;
 
-    EVP_CIPHER_CTX* encryptCtx;
-    EVP_CIPHER_CTX* decryptCtx;
+    EVP_CIPHER_CTX* encryptCtx = nullptr;
+    EVP_CIPHER_CTX* decryptCtx = nullptr;
     // Shared secret
     std::array<uint8_t, 16> sharedSecret;
 
@@ -36,12 +48,56 @@ struct ClientConnection {
     // For teleport confirmation tracking
     std::mutex mutex;
     std::unordered_set<int32_t> pendingTeleportIDs;
-    bool connectionClosed = false;
+    std::atomic<bool> connectionClosed = false;
+
+    // Framed (and encrypted) packets waiting for the next flush, guarded by sendMutex
+    std::deque<FramedPacket> outboundQueue;
+    // Bytes of the front packet that already went out
+    size_t outboundOffset = 0;
+    // Queue depth metrics
+    std::atomic<size_t> outboundPackets = 0;
+    std::atomic<size_t> outboundBytes = 0;
+    std::atomic<size_t> peakOutboundBytes = 0;
+    std::atomic<uint64_t> outboundFlushes = 0;
+
+    // Owned by the I/O thread the connection is pinned to
+    size_t ioThread = 0;
+    RingBuffer inbound;
+    // Backing storage for packets that wrap around the ring buffer or were compressed
+    std::vector<uint8_t> framedPacket;
+    std::vector<uint8_t> inflatedPacket;
+    std::chrono::steady_clock::time_point lastActivity;
+    std::chrono::steady_clock::time_point lastKeepAlive;
+    // Outstanding keep-alive, keepAliveSentAt is reset once it is answered
     int64_t keepAliveID = 0;
+    std::chrono::steady_clock::time_point keepAliveSentAt{};
+    // Smoothed keep-alive round-trip time, zero until the first answer
+    std::chrono::microseconds smoothedRtt{0};
+    // Pending deadline check in the I/O thread's timer wheel
+    uint64_t timerID = 0;
+    // Set while the outbound queue stays above the high-water mark
+    std::chrono::steady_clock::time_point outboundStalledSince{};
+    // Received packets stay buffered while set, e.g. until the shared secret is known
+    bool inboundPaused = false;
+
+    // Login progress
+    LoginStage loginStage = LoginStage::AwaitingStart;
+    std::string loginName;
+    std::array<uint8_t, 16> loginUUID{};
+    std::array<uint8_t, 16> verifyToken{};
+    std::shared_ptr<Player> player;
+
+    ~ClientConnection();
 };
 
+// Players currently in the game
+extern std::atomic<int> playerCount;
+
 void disconnectClient(const std::shared_ptr<Player>& player, const std::string& reason, bool disconnectPacket);
-void handleClient(SocketType clientSock);
+bool handleIncomingPacket(const std::shared_ptr<ClientConnection>& client, std::span<const uint8_t> packetData);
+void handleClientClosed(const std::shared_ptr<ClientConnection>& client);
+// Enforces timeouts and sends keep-alives, nextCheck is set to the connection's next deadline
+bool checkClientTimers(ClientConnection& client, std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point& nextCheck);
 void handleConsoleCommand(const std::string & command);
 void miningScheduler(std::unordered_map<std::string, std::shared_ptr<Player>> &players, std::atomic<bool> &running);
 
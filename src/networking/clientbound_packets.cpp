@@ -16,8 +16,8 @@
 #include "utils/translation.h"
 #include "world/boss_bar.h"
 
-void sendRemoveEntityPacket(const int32_t& entityID) {
-    std::vector<uint8_t> packetData;
+void sendRemoveEntityPacket(ClientConnection& client, int32_t entityID) {
+    PacketWriter packetData;
     packetData.push_back(REMOVE_ENTITIES);
 
     // Number of Entities (VarInt)
@@ -26,12 +26,11 @@ void sendRemoveEntityPacket(const int32_t& entityID) {
     // Entity IDs (VarInt)
     writeVarInt(packetData, entityID);
 
-    // Build and send the packet to all clients
-    broadcastToOthers(packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendPlayerInfoRemove(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(PLAYER_INFO_REMOVE);
 
     // Number Of Players (VarInt)
@@ -41,14 +40,11 @@ void sendPlayerInfoRemove(const std::shared_ptr<Player>& player) {
     packetData.insert(packetData.end(), player->uuid.begin(), player->uuid.end());
 
     // Send to all connected clients
-    std::lock_guard lock(connectedClientsMutex);
-    for (auto &existingClient: connectedClients | std::views::values) {
-        sendPacket(*existingClient, packetData);
-    }
+    broadcastToOthers(std::move(packetData));
 }
 
-void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryManager) {
-    std::vector<uint8_t> packetData;
+bool buildRegistryDataPackets(std::vector<PacketWriter>& packets, RegistryManager& registryManager) {
+    PacketWriter packetData;
     packetData.push_back(REGISTRY_DATA);
 
     // --- Registry 1: dimension_type ---
@@ -58,7 +54,7 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
     std::vector<DimensionType> dimensions;
     if (!loadDimensionTypesFromCompoundFile("../resources/registry_data.json", dimensions)) {
         logMessage("Failed to load dimension data.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in dimension_type
@@ -80,11 +76,10 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtDimenionTypeData.begin(), nbtDimenionTypeData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    packets.push_back(std::move(packetData));
 
     // --- Registry 2: biome ---
-    packetData.clear();
+    packetData = PacketWriter();
     packetData.push_back(REGISTRY_DATA);
     writeString(packetData, "minecraft:worldgen/biome"); // Registry Identifier
 
@@ -92,7 +87,7 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
     std::vector<BiomeRegistryEntry> biomeEntries;
     if (!loadBiomesFromCompoundFile("../resources/registry_data.json", biomeEntries)) {
         logMessage("Failed to load biomes from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in biome
@@ -128,11 +123,10 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         }
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    packets.push_back(std::move(packetData));
 
     // --- Registry 3: painting_variant ---
-    packetData.clear();
+    packetData = PacketWriter();
     packetData.push_back(REGISTRY_DATA);
     writeString(packetData, "minecraft:painting_variant"); // Registry Identifier
 
@@ -140,7 +134,7 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
     std::vector<PaintingVariant> paintingVariants;
     if (!loadPaintingVariantsFromCompoundFile("../resources/registry_data.json", paintingVariants)) {
         logMessage("Failed to load painting variants from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in painting_variant
@@ -162,11 +156,10 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtPaintingVariantData.begin(), nbtPaintingVariantData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    packets.push_back(std::move(packetData));
 
     // --- Registry 4: wolf_variant ---
-    packetData.clear();
+    packetData = PacketWriter();
     packetData.push_back(REGISTRY_DATA);
     writeString(packetData, "minecraft:wolf_variant"); // Registry Identifier
 
@@ -174,7 +167,7 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
     std::vector<WolfVariant> wolfVariants;
     if (!loadWolfVariantsFromCompoundFile("../resources/registry_data.json", wolfVariants)) {
         logMessage("Failed to load wolf variants from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in wolf_variant
@@ -196,11 +189,10 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtWolfVariantData.begin(), nbtWolfVariantData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    packets.push_back(std::move(packetData));
 
     // --- Registry 5: damage_type ---
-    packetData.clear();
+    packetData = PacketWriter();
     packetData.push_back(REGISTRY_DATA);
     writeString(packetData, "minecraft:damage_type"); // Registry Identifier
 
@@ -208,7 +200,7 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
     std::vector<DamageType> damageTypes;
     if (!loadDamageTypesFromCompoundFile("../resources/registry_data.json", damageTypes)) {
         logMessage("Failed to load damage types from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in damage_type
@@ -230,11 +222,10 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtDamageTypeData.begin(), nbtDamageTypeData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    packets.push_back(std::move(packetData));
 
     // --- Registry 6: chat_type ---
-    packetData.clear();
+    packetData = PacketWriter();
     packetData.push_back(REGISTRY_DATA);
     writeString(packetData, "minecraft:chat_type"); // Registry Identifier
 
@@ -277,12 +268,18 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         registryManager.addRegistryEntry("minecraft:chat_type", chatType.identifier);
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    packets.push_back(std::move(packetData));
+    return true;
+}
+
+void sendRegistryDataPacket(ClientConnection& client) {
+    for (const auto& packet : RegistryManager::getInstance().getRegistryDataPackets()) {
+        sendPacket(client, *packet);
+    }
 }
 
 void sendWorldEventPacket(ClientConnection& client, const int& worldEvent, const Position& position, const int& data) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(WORLD_EVENT);
 
     // World Event (Int)
@@ -302,11 +299,10 @@ void sendWorldEventPacket(ClientConnection& client, const int& worldEvent, const
     }
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
-bool sendUpdateTagsPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
+bool buildUpdateTagsPacket(PacketWriter& packetData) {
     packetData.push_back(UPDATE_TAGS);
 
     // Number of Tags to update
@@ -361,14 +357,19 @@ bool sendUpdateTagsPacket(ClientConnection& client) {
         }
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
-
     return true;
 }
 
+bool sendUpdateTagsPacket(ClientConnection& client) {
+    EncodedPacket* packet = RegistryManager::getInstance().getTagsPacket();
+    if (!packet) {
+        return false;
+    }
+    return sendPacket(client, *packet);
+}
+
 void sendJoinGamePacket(ClientConnection& client, int32_t entityID) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(LOGIN);
 
     // 1. Entity ID (Int)
@@ -434,13 +435,14 @@ void sendJoinGamePacket(ClientConnection& client, int32_t entityID) {
     //packetData.push_back(0x00); // 0 (unused, required in 1.21.3)
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendSynchronizePlayerPositionPacket(ClientConnection& client, const std::shared_ptr<Player> &player) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(SYNCHRONIZE_PLAYER_POSITION);
 
+    std::lock_guard poseLock(player->poseMutex);
     if(player->newSpawn) {
         // If the player's position is not set, use the spawn position
         player->position = spawnPosition;
@@ -480,14 +482,14 @@ void sendSynchronizePlayerPositionPacket(ClientConnection& client, const std::sh
     }
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 
     // Update client state to AwaitingTeleportConfirm
     client.state = ClientState::AwaitingTeleportConfirm;
 }
 
 void sendEntityRelativeMovePacket(const std::shared_ptr<Entity>& entity, short deltaX, short deltaY, short deltaZ) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(UPDATE_ENTITY_POSITION);
 
     // Entity ID (VarInt)
@@ -500,12 +502,12 @@ void sendEntityRelativeMovePacket(const std::shared_ptr<Entity>& entity, short d
     // On Ground (Boolean)
     packetData.push_back(entity->onGround ? 0x01 : 0x00);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(entity->entityID, std::move(packetData));
 }
 
-void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ) {
-    std::vector<uint8_t> packetData;
+void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, bool onGround) {
+    PacketWriter packetData;
     packetData.push_back(UPDATE_ENTITY_POSITION);
 
     // Entity ID (VarInt)
@@ -516,14 +518,14 @@ void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short d
     writeShort(packetData, deltaZ);
 
     // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
+    packetData.push_back(onGround ? 0x01 : 0x00);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(player->entityID, std::move(packetData));
 }
 
-void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, float yaw, float pitch) {
-    std::vector<uint8_t> packetData;
+void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, uint8_t yaw, uint8_t pitch, bool onGround) {
+    PacketWriter packetData;
     packetData.push_back(UPDATE_ENTITY_POSITION_AND_ROTATION);
 
     // Entity ID (VarInt)
@@ -533,84 +535,74 @@ void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player,
     writeShort(packetData, deltaY);
     writeShort(packetData, deltaZ);
 
-    // Yaw, Pitch (Byte)
-    auto yawByte = static_cast<uint8_t>(yaw / (360.0f / 256.0f));
-    auto pitchByte = static_cast<uint8_t>(pitch / (360.0f / 256.0f));
-
-    packetData.push_back(yawByte);
-    packetData.push_back(pitchByte);
+    // Yaw, Pitch (Angle)
+    packetData.push_back(yaw);
+    packetData.push_back(pitch);
 
     // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
+    packetData.push_back(onGround ? 0x01 : 0x00);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(player->entityID, std::move(packetData));
 }
 
-void sendEntityRotationPacket(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
+void sendEntityRotationPacket(const std::shared_ptr<Player>& player, uint8_t yaw, uint8_t pitch, bool onGround) {
+    PacketWriter packetData;
     packetData.push_back(UPDATE_ENTITY_ROTATION);
 
     // Entity ID (VarInt)
     writeVarInt(packetData, player->entityID);
 
-    // Yaw, Pitch (Byte)
-    auto yawByte = static_cast<uint8_t>(player->rotation.yaw / (360.0f / 256.0f));
-    auto pitchByte = static_cast<uint8_t>(player->rotation.pitch / (360.0f / 256.0f));
-
-    packetData.push_back(yawByte);
-    packetData.push_back(pitchByte);
+    // Yaw, Pitch (Angle)
+    packetData.push_back(yaw);
+    packetData.push_back(pitch);
 
     // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
+    packetData.push_back(onGround ? 0x01 : 0x00);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(player->entityID, std::move(packetData));
 }
 
-void sendHeadRotationPacket(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
+void sendHeadRotationPacket(const std::shared_ptr<Player>& player, uint8_t headYaw) {
+    PacketWriter packetData;
     packetData.push_back(SET_HEAD_ROTATION);
 
     // Entity ID (VarInt)
     writeVarInt(packetData, player->entityID);
 
-    // Head Yaw (Byte)
-    auto headYawByte = static_cast<uint8_t>(player->rotation.headYaw / (360.0f / 256.0f));
-    packetData.push_back(headYawByte);
+    // Head Yaw (Angle)
+    packetData.push_back(headYaw);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(player->entityID, std::move(packetData));
 }
 
-void sendEntityTeleportPacket(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
+void sendEntityTeleportPacket(const std::shared_ptr<Player>& player, double x, double y, double z, uint8_t yaw, uint8_t pitch, bool onGround) {
+    PacketWriter packetData;
     packetData.push_back(TELEPORT_ENTITY);
 
     // Entity ID (VarInt)
     writeVarInt(packetData, player->entityID);
 
     // X, Y, Z (Double)
-    writeDouble(packetData, player->position.x);
-    writeDouble(packetData, player->position.y);
-    writeDouble(packetData, player->position.z);
+    writeDouble(packetData, x);
+    writeDouble(packetData, y);
+    writeDouble(packetData, z);
 
-    // Yaw, Pitch (Byte)
-    auto yawByte = static_cast<uint8_t>(player->rotation.yaw / (360.0f / 256.0f));
-    auto pitchByte = static_cast<uint8_t>(player->rotation.pitch / (360.0f / 256.0f));
-
-    packetData.push_back(yawByte);
-    packetData.push_back(pitchByte);
+    // Yaw, Pitch (Angle)
+    packetData.push_back(yaw);
+    packetData.push_back(pitch);
 
     // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
+    packetData.push_back(onGround ? 0x01 : 0x00);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(player->entityID, std::move(packetData));
 }
 
-void sendSpawnEntityPacket(const std::shared_ptr<Entity>& entity) {
-    std::vector<uint8_t> packetData;
+void sendSpawnEntityPacket(ClientConnection& client, const std::shared_ptr<Entity>& entity) {
+    PacketWriter packetData;
     packetData.push_back(SPAWN_ENTITY);
 
     // Entity ID (VarInt)
@@ -636,68 +628,23 @@ void sendSpawnEntityPacket(const std::shared_ptr<Entity>& entity) {
     packetData.push_back(yaw);
     packetData.push_back(headYaw);
 
-    // Data - Additional data depending on entity type
-    std::vector<uint8_t> additionalData;
-    entity->serializeAdditionalData(additionalData);
-    writeVarInt(packetData, static_cast<int32_t>(additionalData.size()));
-    packetData.insert(packetData.end(), additionalData.begin(), additionalData.end());
-
-    // Velocity (Fixed-point, scaled by 8000)
-    auto fixedMotionX = static_cast<int16_t>(entity->getMotionX() * 8000);
-    auto fixedMotionY = static_cast<int16_t>(entity->getMotionY() * 8000);
-    auto fixedMotionZ = static_cast<int16_t>(entity->getMotionZ() * 8000);
-    writeShort(packetData, fixedMotionX);
-    writeShort(packetData, fixedMotionY);
-    writeShort(packetData, fixedMotionZ);
-
-    // Build and send the packet with length prefix
-    broadcastToOthers(packetData);
-}
-
-void sendSpawnEntityPacket(ClientConnection& client, const std::shared_ptr<Entity>& entity) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SPAWN_ENTITY);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, entity->entityID);
-
-    // Entity UUID (UUID - 16 bytes)
-    packetData.insert(packetData.end(), entity->uuid.begin(), entity->uuid.end());
-
-    // Type (VarInt) - Entity type ID from minecraft:entity_type registry
-    writeVarInt(packetData, static_cast<int32_t>(entity->type));
-
-    // X, Y, Z (Double)
-    writeDouble(packetData, entity->position.x);
-    writeDouble(packetData, entity->position.y);
-    writeDouble(packetData, entity->position.z);
-
-    // Pitch, Yaw, Head Yaw (Angles as bytes)
-    auto pitch = static_cast<uint8_t>(entity->rotation.pitch / (360.0f / 256.0f));
-    auto yaw = static_cast<uint8_t>(entity->rotation.yaw / (360.0f / 256.0f));
-    auto headYaw = static_cast<uint8_t>(entity->rotation.headYaw / (360.0f / 256.0f));
-
-    packetData.push_back(pitch);
-    packetData.push_back(yaw);
-    packetData.push_back(headYaw);
-
     // Data (VarInt) - Additional data depending on entity type
     std::vector<uint8_t> additionalData;
     entity->serializeAdditionalData(additionalData);
     writeVarInt(packetData, static_cast<int32_t>(additionalData.size()));
     packetData.insert(packetData.end(), additionalData.begin(), additionalData.end());
 
-    // Velocity X, Y, Z (Short) - set to 0 for now
-    writeShort(packetData, 0); // Velocity X
-    writeShort(packetData, 0); // Velocity Y
-    writeShort(packetData, 0); // Velocity Z
+    // Velocity (Fixed-point, scaled by 8000)
+    writeShort(packetData, static_cast<int16_t>(entity->getMotionX() * 8000));
+    writeShort(packetData, static_cast<int16_t>(entity->getMotionY() * 8000));
+    writeShort(packetData, static_cast<int16_t>(entity->getMotionZ() * 8000));
 
     // Build and send the packet with length prefix
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t entityStatus) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(ENTITY_EVENT);
 
     // Entity ID (VarInt)
@@ -707,11 +654,10 @@ void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t e
     writeByte(packetData, entityStatus);
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
-void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions) {
-    std::vector<uint8_t> packetData = { };
+static bool buildPlayerInfoUpdate(std::vector<uint8_t>& packetData, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions) {
     packetData.push_back(PLAYER_INFO_UPDATE);
 
     // Actions Byte
@@ -753,19 +699,19 @@ void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std:
                 if (player->sessionId.size() != 16) {
                     logMessage("Invalid Session ID size for player: " + player->name, LOG_ERROR);
                     disconnectClient(player, "Invalid Session ID size", true);
-                    return;
+                    return false;
                 }
 
                 if (player->sessionKey.pubKey.size() > 512) {
                     logMessage("Public Key size exceeds 512 bytes for player: " + player->name, LOG_ERROR);
                     disconnectClient(player, "Public Key size exceeds 512 bytes", true);
-                    return;
+                    return false;
                 }
 
                 if (player->sessionKey.keySig.size() > 4096) {
                     logMessage("Public Key Signature size exceeds 4096 bytes for player: " + player->name, LOG_ERROR);
                     disconnectClient(player, "Public Key Signature size exceeds 4096 bytes", true);
-                    return;
+                    return false;
                 }
                 // Chat Session ID (UUID)
                 writeBytes(packetData, player->sessionId);
@@ -814,12 +760,25 @@ void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std:
         }
     }
 
-    // Send the packet to the target client
-    sendPacket(targetClient, packetData);
+    return true;
+}
+
+void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions) {
+    PacketWriter packetData;
+    if (buildPlayerInfoUpdate(packetData, playersToUpdate, actions)) {
+        sendPacket(targetClient, std::move(packetData));
+    }
+}
+
+void sendPlayerInfoUpdate(const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions, const std::string& excludeUUID) {
+    PacketWriter packetData;
+    if (buildPlayerInfoUpdate(packetData, playersToUpdate, actions)) {
+        broadcastToOthers(std::move(packetData), excludeUUID);
+    }
 }
 
 void sendGameEventPacket(ClientConnection& targetClient, GameEvent event, float value) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(GAME_EVENT);
 
     // Event (Unsigned Byte)
@@ -829,11 +788,11 @@ void sendGameEventPacket(ClientConnection& targetClient, GameEvent event, float
     writeFloat(packetData, value);
 
     // Send the packet
-    sendPacket(targetClient, packetData);
+    sendPacket(targetClient, std::move(packetData));
 }
 
 void sendGameEvent(GameEvent event, float value) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(GAME_EVENT);
 
     // Event (Unsigned Byte)
@@ -843,7 +802,7 @@ void sendGameEvent(GameEvent event, float value) {
     writeFloat(packetData, value);
 
     // Broadcast to all clients
-    broadcastToOthers(packetData);
+    broadcastToOthers(std::move(packetData));
 }
 
 void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>& player, Gamemode gameMode) {
@@ -852,7 +811,7 @@ void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>&
     }
 
 void sendRemoveEntitiesPacket(const std::vector<int32_t>& entityIDs) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(REMOVE_ENTITIES);
 
     // Number of Entities (VarInt)
@@ -864,15 +823,16 @@ void sendRemoveEntitiesPacket(const std::vector<int32_t>& entityIDs) {
     }
 
     // Build and send the packet to all clients
-    broadcastToOthers(packetData);
+    broadcastToOthers(std::move(packetData));
 }
 
 void sendTranslatedChatMessage(const std::string& key, const bool actionBar, const std::string& color, const std::vector<std::shared_ptr<Player>>* players, bool log, const std::vector<std::string>* args) {
-    std::vector<uint8_t> packetData = { };
-
-    if (players == nullptr) {
-        for (const auto &player: globalPlayers | std::views::values) {
-            packetData.clear();
+    // Encode the message once per language instead of once per player
+    std::unordered_map<std::string, std::unique_ptr<EncodedPacket>> packetsByLang;
+    auto sendTo = [&](const std::shared_ptr<Player>& player) {
+        auto& packet = packetsByLang[player->lang];
+        if (!packet) {
+            std::vector<uint8_t> packetData;
             packetData.push_back(SYSTEM_CHAT_MESSAGE);
 
             nbt::tag_compound textCompound = createTextComponent(getTranslation(key, player->lang, *args), color);
@@ -880,21 +840,20 @@ void sendTranslatedChatMessage(const std::string& key, const bool actionBar, con
             packetData.insert(packetData.end(), textData.begin(), textData.end());
 
             writeByte(packetData, actionBar);
-            sendPacket(*player->client, packetData);
+            packet = std::make_unique<EncodedPacket>(std::move(packetData));
+        }
+        sendPacket(*player->client, *packet);
+    };
+
+    if (players == nullptr) {
+        for (const auto &player: globalPlayers | std::views::values) {
+            sendTo(player);
         }
     }
     else {
         for (const auto& player : *players) {
             if (player->client != nullptr) {
-                packetData.clear();
-                packetData.push_back(SYSTEM_CHAT_MESSAGE);
-
-                nbt::tag_compound textCompound = createTextComponent(getTranslation(key, player->lang, *args), color);
-                std::vector<uint8_t> textData = serializeNBT(textCompound, true);
-                packetData.insert(packetData.end(), textData.begin(), textData.end());
-
-                writeByte(packetData, actionBar);
-                sendPacket(*player->client, packetData);
+                sendTo(player);
             }
         }
     }
@@ -904,7 +863,7 @@ void sendTranslatedChatMessage(const std::string& key, const bool actionBar, con
 }
 
 void sendChatMessage(const std::string& message, const bool actionBar, const std::string& color, const std::vector<std::shared_ptr<Player>>* players, bool log) {
-    std::vector<uint8_t> packetData = { };
+    PacketWriter packetData;
     packetData.push_back(SYSTEM_CHAT_MESSAGE);
 
     nbt::tag_compound textCompound = createTextComponent(message, color);
@@ -914,12 +873,13 @@ void sendChatMessage(const std::string& message, const bool actionBar, const std
     writeByte(packetData, actionBar);
 
     if (players == nullptr) {
-        broadcastToOthers(packetData, "");
+        broadcastToOthers(std::move(packetData), "");
     }
     else {
+        EncodedPacket packet(std::move(packetData));
         for (const auto& player : *players) {
             if (player->client != nullptr) {
-                sendPacket(*player->client, packetData);
+                sendPacket(*player->client, packet);
             }
         }
     }
@@ -936,7 +896,7 @@ void sendChatMessage(const std::string& message, const bool actionBar, const std
 }
 
 void sendSetCenterChunkPacket(ClientConnection& targetClient, int32_t chunkX, int32_t chunkZ) {
-    std::vector<uint8_t> packetData = { };
+    PacketWriter packetData;
     packetData.push_back(SET_CENTER_CHUNK);
 
     // Serialize Chunk X (VarInt)
@@ -946,12 +906,39 @@ void sendSetCenterChunkPacket(ClientConnection& targetClient, int32_t chunkX, in
     writeVarInt(packetData, chunkZ);
 
     // Send the packet to the target client
-   sendPacket(targetClient, packetData);
+   sendPacket(targetClient, std::move(packetData));
+}
+
+void sendChunkBatchStartPacket(ClientConnection& targetClient) {
+    PacketWriter packetData;
+    packetData.push_back(CHUNK_BATCH_START);
+    sendPacket(targetClient, std::move(packetData));
+}
+
+void sendChunkBatchFinishedPacket(ClientConnection& targetClient, int32_t batchSize) {
+    PacketWriter packetData;
+    packetData.push_back(CHUNK_BATCH_FINISHED);
+
+    // Batch Size (VarInt), the client times the batch to work out its rate
+    writeVarInt(packetData, batchSize);
+    sendPacket(targetClient, std::move(packetData));
+}
+
+void sendUnloadChunkPacket(ClientConnection& targetClient, int32_t chunkX, int32_t chunkZ) {
+    PacketWriter packetData;
+    packetData.push_back(UNLOAD_CHUNK);
+
+    // Chunk Z comes first (Int)
+    writeInt(packetData, chunkZ);
+
+    // Chunk X (Int)
+    writeInt(packetData, chunkX);
+    sendPacket(targetClient, std::move(packetData));
 }
 
 void sendResourcePacks(ClientConnection& client) {
     for (const auto& pack : serverConfig.resourcePacks) {
-        std::vector<uint8_t> packetData;
+        PacketWriter packetData;
         writeVarInt(packetData, ADD_RESOURCE_PACK_PLAY);
 
         // Resource Pack Push Fields
@@ -973,12 +960,12 @@ void sendResourcePacks(ClientConnection& client) {
         }
 
         // Send the packet
-        sendPacket(client, packetData);
+        sendPacket(client, std::move(packetData));
     }
 }
 
 void sendRemoveResourcePacks(ClientConnection& client, const std::vector<std::string>& uuidsToRemove) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     writeVarInt(packetData, REMOVE_RESOURCE_PACK_CONFIG);
 
     if (uuidsToRemove.empty()) {
@@ -993,24 +980,26 @@ void sendRemoveResourcePacks(ClientConnection& client, const std::vector<std::st
     }
 
     // Send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 bool sendKeepAlivePacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(KEEP_ALIVE_PLAY);
 
     // Keep Alive ID (Long)
     int64_t keepAliveID = std::chrono::system_clock::now().time_since_epoch().count();
     writeLong(packetData, keepAliveID);
+    // Only sent once the previous one was answered
     client.keepAliveID = keepAliveID;
+    client.keepAliveSentAt = std::chrono::steady_clock::now();
 
     // Build and send the packet
-    return sendPacket(client, packetData);
+    return sendPacket(client, std::move(packetData));
 }
 
 void sendEntityMetadataPacket(const std::vector<MetadataEntry>& metadataEntries, int32_t entityID) {
-    std::vector<uint8_t> packetData = { };
+    PacketWriter packetData;
 
     // Packet ID for Entity Metadata
     packetData.push_back(SET_ENTITY_METADATA);
@@ -1033,12 +1022,12 @@ void sendEntityMetadataPacket(const std::vector<MetadataEntry>& metadataEntries,
     // Terminating Entry (0xFF)
     packetData.push_back(0xFF);
 
-    // Broadcast the packet to all other clients
-    broadcastToOthers(packetData);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(entityID, std::move(packetData));
 }
 
-void sendEntityMetadataPacket(const std::shared_ptr<Player>& player, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID) {
-    std::vector<uint8_t> packetData = { };
+void sendEntityMetadataPacket(ClientConnection& client, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID) {
+    PacketWriter packetData;
 
     // Packet ID for Entity Metadata
     packetData.push_back(SET_ENTITY_METADATA);
@@ -1061,12 +1050,11 @@ void sendEntityMetadataPacket(const std::shared_ptr<Player>& player, const std::
     // Terminating Entry (0xFF)
     packetData.push_back(0xFF);
 
-    // Broadcast the packet to all other clients except the initiating player
-    broadcastToOthers(packetData, player->uuidString);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendEntityAnimation(const std::shared_ptr<Player> & player, EntityAnimation animation) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(ENTITY_ANIMATION);
 
     // Entity ID (VarInt)
@@ -1075,23 +1063,23 @@ void sendEntityAnimation(const std::shared_ptr<Player> & player, EntityAnimation
     // Animation ID (Unsigned Byte)
     packetData.push_back(static_cast<uint8_t>(animation));
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(player->entityID, std::move(packetData));
 }
 
 void sendAcknowledgeBlockChange(ClientConnection& client, size_t sequenceID) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(ACKNOWLEDGE_BLOCK_CHANGE);
 
     // Sequence ID (VarInt)
     writeVarInt(packetData, static_cast<int32_t>(sequenceID));
 
     // Send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
-void sendEquipmentPacket(const std::shared_ptr<Player> & player, int32_t entityID, const EquipmentSlot& slot) {
-    std::vector<uint8_t> packetData;
+void sendEquipmentPacket(int32_t entityID, const EquipmentSlot& slot) {
+    PacketWriter packetData;
     packetData.push_back(SET_EQUIPMENT);
 
     // Entity ID (VarInt)
@@ -1103,12 +1091,12 @@ void sendEquipmentPacket(const std::shared_ptr<Player> & player, int32_t entityI
     // Item (Slot)
     writeSlotSimple(packetData, slot.slotData);
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(entityID, std::move(packetData));
 }
 
 void broadcastPlayerChatMessage(const std::shared_ptr<Player>& sender, const std::string& message, long timestamp, long salt, const std::vector<uint8_t>* signature, const RegistryManager& registryManager, const std::string& chatTypeIdentifier, const std::string& targetName) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(PLAYER_CHAT_MESSAGE);
 
     // Sender UUID
@@ -1170,17 +1158,12 @@ void broadcastPlayerChatMessage(const std::shared_ptr<Player>& sender, const std
     }
 
     // Broadcast to all players
-    {
-        std::lock_guard lock(connectedClientsMutex);
-        for (auto &client: connectedClients | std::views::values) {
-            sendPacket(*client, packetData);
-        }
-    }
+    broadcastToOthers(std::move(packetData));
     logMessage("<" + sender->name + "> " + message, LOG_RAW);
 }
 
 void sendCommandsPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(COMMANDS);
 
     // Write the Count (number of nodes)
@@ -1192,21 +1175,21 @@ void sendCommandsPacket(ClientConnection& client) {
     // Write the Root index
     writeVarInt(packetData, serializedCommandGraph.second);
 
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendFinishConfigurationPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(FINISH_CONFIGURATION);
 
     // No fields in this packet
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendKnownPacksPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(CLIENTBOUND_KNOWN_PACKS);
     // For now, only minecraft:core version 1.21
     writeVarInt(packetData, 1); // Number of packs
@@ -1215,19 +1198,19 @@ void sendKnownPacksPacket(ClientConnection& client) {
     writeString(packetData, "core"); // Pack ID
     writeString(packetData, "1.21"); // Pack Version
 
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendSetCompressionPacket(ClientConnection& client, int32_t threshold) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(SET_COMPRESSION);
     writeVarInt(packetData, threshold); // Compression threshold
 
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendDisconnectionPacket(ClientConnection& client, const std::string& reason) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(DISCONNECT);
 
     // Serialize the reason as a JSON text component
@@ -1237,11 +1220,11 @@ void sendDisconnectionPacket(ClientConnection& client, const std::string& reason
     std::string reasonStr = textComponent.dump();
     writeString(packetData, reasonStr);
 
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendServerLinksPacket(ClientConnection & client) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(SERVER_LINKS);
 
     writeVarInt(packetData, static_cast<int32_t>(serverConfig.serverLinks.size()));
@@ -1253,11 +1236,11 @@ void sendServerLinksPacket(ClientConnection & client) {
         writeString(packetData, link.url);
     }
 
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendServerPluginMessages(ClientConnection & client) {
-    std::vector<uint8_t> packetData;
+    PacketWriter packetData;
     packetData.push_back(CLIENTBOUND_PLUGIN_MESSAGE_CONFIG);
 
     std::string channel = "minecraft:brand";
@@ -1266,11 +1249,11 @@ void sendServerPluginMessages(ClientConnection & client) {
     std::string brand = "MCpp";
     writeString(packetData, brand);
 
-    sendPacket(client, packetData);
+    sendPacket(client, std::move(packetData));
 }
 
 void sendReInitializeWorldBorder(double x, double z, double size, int64_t speed, int32_t warningBlocks, int32_t warningTime) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeVarInt(packet, INITIALIZE_WORLD_BORDER);
     double oldDiameter = worldBorder.size;
     worldBorder.updateCenter(x, z);
@@ -1304,11 +1287,11 @@ void sendReInitializeWorldBorder(double x, double z, double size, int64_t speed,
     writeVarInt(packet, warningTime);
 
     // Send the packet
-    broadcastToOthers(packet);
+    broadcastToOthers(std::move(packet));
 }
 
 void sendInitializeWorldBorder(ClientConnection& client, const WorldBorder& border) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeVarInt(packet, INITIALIZE_WORLD_BORDER);
 
     // Bound To: X (Double) - Center X
@@ -1336,11 +1319,11 @@ void sendInitializeWorldBorder(ClientConnection& client, const WorldBorder& bord
     writeVarInt(packet, border.warningTime);
 
     // Send the packet
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
-void sendTimeUpdatePacket(ClientConnection& client) {
-    std::vector<uint8_t> packet;
+static PacketWriter buildTimeUpdatePacket() {
+    PacketWriter packet;
     writeVarInt(packet, UPDATE_TIME);
 
     // World Age (Long) - Not changed by server commands
@@ -1350,13 +1333,33 @@ void sendTimeUpdatePacket(ClientConnection& client) {
     // Time of Day (Long) - Based on world time
     int64_t currentTimeOfDay = worldTime.getTimeOfDay();
     writeLong(packet, currentTimeOfDay);
+    return packet;
+}
 
-    // Send the packet
-    sendPacket(client, packet);
+void sendTimeUpdatePacket(ClientConnection& client) {
+    sendPacket(client, buildTimeUpdatePacket());
+}
+
+void sendTimeUpdate() {
+    broadcastToOthers(buildTimeUpdatePacket());
+}
+
+void sendLatencyUpdate() {
+    std::vector<std::shared_ptr<Player>> players;
+    {
+        std::lock_guard lock(playersMutex);
+        players.reserve(globalPlayers.size());
+        for (const auto& player : globalPlayers | std::views::values) {
+            players.push_back(player);
+        }
+    }
+    if (!players.empty()) {
+        sendPlayerInfoUpdate(players, 0x10); // 0x10: Update Latency
+    }
 }
 
 void sendSetBorderCenter(double x, double z) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_BORDER_CENTER);
     worldBorder.updateCenter(x, z);
 
@@ -1367,11 +1370,11 @@ void sendSetBorderCenter(double x, double z) {
     writeDouble(packet, worldBorder.centerZ);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(std::move(packet));
 }
 
 void sendSetBorderLerpSize(double newDiameter, int64_t speed) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_BORDER_LERP_SIZE);
     double oldDiameter = worldBorder.size;
     worldBorder.updateSize(newDiameter);
@@ -1386,11 +1389,11 @@ void sendSetBorderLerpSize(double newDiameter, int64_t speed) {
     writeVarLong(packet, speed);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(std::move(packet));
 }
 
 void sendSetBorderSize(double newDiameter) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_BORDER_SIZE);
     worldBorder.updateSize(newDiameter);
 
@@ -1398,11 +1401,11 @@ void sendSetBorderSize(double newDiameter) {
     writeDouble(packet, worldBorder.size);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(std::move(packet));
 }
 
 void sendSetBorderWarningDelay(int32_t warningTime) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_BORDER_WARNING_DELAY);
     worldBorder.updateWarningTime(warningTime);
 
@@ -1410,11 +1413,11 @@ void sendSetBorderWarningDelay(int32_t warningTime) {
     writeVarInt(packet, worldBorder.warningTime);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(std::move(packet));
 }
 
 void sendSetBorderWarningDistance(int32_t warningBlocks) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_BORDER_WARNING_DISTANCE);
     worldBorder.updateWarningDistance(warningBlocks);
 
@@ -1422,11 +1425,11 @@ void sendSetBorderWarningDistance(int32_t warningBlocks) {
     writeVarInt(packet, worldBorder.warningBlocks);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(std::move(packet));
 }
 
 void sendBossbar(Bossbar& bossbar, int32_t action) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, BOSS_BAR);
     std::array<uint8_t, 16> uuid = bossbar.getUUID();
     std::vector<uint8_t> uuidBytes;
@@ -1480,15 +1483,16 @@ void sendBossbar(Bossbar& bossbar, int32_t action) {
             return;
         }
     }
-    for (const auto player : bossbar.getPlayers()) {
+    EncodedPacket encoded(std::move(packet));
+    for (const auto& player : bossbar.getPlayers()) {
         if (player->client != nullptr) {
-            sendPacket(*player->client, packet);
+            sendPacket(*player->client, encoded);
         }
     }
 }
 
 void sendCommandSuggestionsResponse(ClientConnection& client, int32_t transactionID, const std::vector<std::string>& suggestions, int32_t start) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeVarInt(packet, COMMAND_SUGGESTIONS_RESPONSE);
     writeVarInt(packet, transactionID);
     writeVarInt(packet, start);
@@ -1498,23 +1502,17 @@ void sendCommandSuggestionsResponse(ClientConnection& client, int32_t transactio
         writeString(packet, suggestion);
         writeByte(packet, 0x00); // No text component
     }
-    sendPacket(client, packet);
-}
-
-void sendBundleDelimiter() {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, BUNDLE_DELIMITER);
-    broadcastToOthers(packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendBundleDelimiter(ClientConnection& client) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeVarInt(packet, BUNDLE_DELIMITER);
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendEntityVelocity(const std::shared_ptr<Entity>& entity) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeVarInt(packet, SET_ENTITY_VELOCITY);
 
     // Entity ID (VarInt)
@@ -1529,12 +1527,12 @@ void sendEntityVelocity(const std::shared_ptr<Entity>& entity) {
     // Velocity Z (Short)
     writeShort(packet, static_cast<int16_t>(entity->getMotionZ() * 8000));
 
-    // Broadcast to all clients
-    broadcastToOthers(packet);
+    // Broadcast to the players tracking the entity
+    entityTracker.broadcast(entity->entityID, std::move(packet));
 }
 
 void sendPickUpItem(const std::shared_ptr<Entity>& collectedEntity, const std::shared_ptr<Entity>& collectorEntity, int8_t count) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, PICK_UP_ITEM);
 
     // Collected Entity ID (VarInt)
@@ -1546,12 +1544,12 @@ void sendPickUpItem(const std::shared_ptr<Entity>& collectedEntity, const std::s
     // Count (VarInt)
     writeVarInt(packet, count);
 
-    // Broadcast to all clients
-    broadcastToOthers(packet);
+    // Broadcast to the players tracking the item, the collector among them
+    entityTracker.broadcast(collectedEntity->entityID, std::move(packet));
 }
 
 void SendSetContainerSlot(ClientConnection& client, const int8_t windowID, const int32_t stateID, const uint16_t slotID, const SlotData& slot) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_CONTAINER_SLOT);
 
     // Window ID (Byte)
@@ -1566,11 +1564,11 @@ void SendSetContainerSlot(ClientConnection& client, const int8_t windowID, const
     // Slot (Slot)
     writeSlotSimple(packet, slot);
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendUpdateRecipes(ClientConnection& client) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, UPDATE_RECIPES);
 
     /*
@@ -1584,12 +1582,12 @@ void sendUpdateRecipes(ClientConnection& client) {
     writeBytes(packet, craftingRecipes.find(36)->second.serialize(36));
 
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
     */
 }
 
 void sendContainerContent(ClientConnection& client, uint8_t windowID, int32_t stateID, Inventory& inventory) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_CONTAINER_CONTENT);
 
     writeUByte(packet, windowID);
@@ -1607,11 +1605,11 @@ void sendContainerContent(ClientConnection& client, uint8_t windowID, int32_t st
     }
     writeSlotSimple(packet, inventory.carriedItem);
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendOpenScreen(ClientConnection& client, const uint8_t windowID, const uint8_t windowType, const std::string& title) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, OPEN_SCREEN);
 
     writeVarInt(packet, windowID);
@@ -1619,11 +1617,11 @@ void sendOpenScreen(ClientConnection& client, const uint8_t windowID, const uint
     nbt::tag_compound titleTag = createTextComponent(title);
     writeBytes(packet, serializeNBT(titleTag, true));
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendBlockDestroyStage(const std::shared_ptr<Player>& player, const Position &blockPos, const int8_t stage) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, BLOCK_DESTROY_STAGE);
 
     // Entity ID (VarInt)
@@ -1635,12 +1633,12 @@ void sendBlockDestroyStage(const std::shared_ptr<Player>& player, const Position
     // Destroy Stage (Byte)
     writeByte(packet, stage);
 
-    // Broadcast to all clients // TODO: Only broadcast to clients that have the chunk loaded
-    broadcastToOthers(packet, player->uuidString);
+    // Broadcast to the players tracking the digging player
+    entityTracker.broadcast(player->entityID, std::move(packet));
 }
 
 void sendUpdateAttributes(ClientConnection& client, const int32_t entityID, const std::vector<Attribute>& attributes) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, UPDATE_ATTRIBUTES);
 
     // Entity ID (VarInt)
@@ -1672,11 +1670,11 @@ void sendUpdateAttributes(ClientConnection& client, const int32_t entityID, cons
         */
     }
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendPlayerAbilities(ClientConnection& client, const uint8_t flags, const float flyingSpeed, const float fovModifier) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, PLAYER_ABILITIES);
 
     // Flags (Unsigned Byte)
@@ -1688,21 +1686,21 @@ void sendPlayerAbilities(ClientConnection& client, const uint8_t flags, const fl
     // Walking Speed (Float)
     writeFloat(packet, fovModifier);
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendSetHeldItem(ClientConnection& client, const int8_t slot) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, SET_HELD_ITEM);
 
     // Slot (Byte)
     writeByte(packet, slot);
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
 
 void sendFeatureFlags(ClientConnection& client, const std::vector<std::string>& flags) {
-    std::vector<uint8_t> packet;
+    PacketWriter packet;
     writeByte(packet, FEATURE_FLAGS);
 
     // Flags (Identifier Array)
@@ -1711,5 +1709,5 @@ void sendFeatureFlags(ClientConnection& client, const std::vector<std::string>&
         writeString(packet, flag);
     }
 
-    sendPacket(client, packet);
+    sendPacket(client, std::move(packet));
 }
\ No newline at end of file
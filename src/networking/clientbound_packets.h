@@ -21,23 +21,28 @@ enum class GameEvent : uint8_t;
 class Entity;
 struct Position;
 
-void sendRemoveEntityPacket(const int32_t& entityID);
+void sendRemoveEntityPacket(ClientConnection& client, int32_t entityID);
 void sendPlayerInfoRemove(const std::shared_ptr<Player>& player);
-void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryManager);
+// Configuration phase payloads, built once at startup by the RegistryManager
+bool buildRegistryDataPackets(std::vector<PacketWriter>& packets, RegistryManager& registryManager);
+bool buildUpdateTagsPacket(PacketWriter& packetData);
+void sendRegistryDataPacket(ClientConnection& client);
 void sendWorldEventPacket(ClientConnection& client, const int& worldEvent, const Position& position, const int& data);
 bool sendUpdateTagsPacket(ClientConnection& client);
 void sendJoinGamePacket(ClientConnection& client, int32_t entityID);
 void sendSynchronizePlayerPositionPacket(ClientConnection& client, const std::shared_ptr<Player> &player);
 void sendEntityRelativeMovePacket(const std::shared_ptr<Entity>& entity, short deltaX, short deltaY, short deltaZ);
-void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ);
-void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, float yaw, float pitch);
-void sendEntityRotationPacket(const std::shared_ptr<Player>& player);
-void sendHeadRotationPacket(const std::shared_ptr<Player>& player);
-void sendEntityTeleportPacket(const std::shared_ptr<Player>& player);
-void sendSpawnEntityPacket(const std::shared_ptr<Entity>& entity);
+void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, bool onGround);
+void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, uint8_t yaw, uint8_t pitch, bool onGround);
+void sendEntityRotationPacket(const std::shared_ptr<Player>& player, uint8_t yaw, uint8_t pitch, bool onGround);
+void sendHeadRotationPacket(const std::shared_ptr<Player>& player, uint8_t headYaw);
+void sendEntityTeleportPacket(const std::shared_ptr<Player>& player, double x, double y, double z, uint8_t yaw, uint8_t pitch, bool onGround);
 void sendSpawnEntityPacket(ClientConnection& client, const std::shared_ptr<Entity>& entity);
 void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t entityStatus);
 void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions);
+void sendPlayerInfoUpdate(const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions, const std::string& excludeUUID = "");
+// Tab list latency of every player, from their smoothed keep-alive round-trip time
+void sendLatencyUpdate();
 void sendGameEventPacket(ClientConnection& targetClient, GameEvent event, float value);
 void sendGameEvent(GameEvent event, float value);
 void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>& player, Gamemode gameMode);
@@ -49,14 +54,17 @@ void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t e
 void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>& player, Gamemode gameMode);
 void sendDisconnectionPacket(ClientConnection& client, const std::string& reason);
 void sendSetCenterChunkPacket(ClientConnection& targetClient, int32_t chunkX, int32_t chunkZ);
+void sendChunkBatchStartPacket(ClientConnection& targetClient);
+void sendChunkBatchFinishedPacket(ClientConnection& targetClient, int32_t batchSize);
+void sendUnloadChunkPacket(ClientConnection& targetClient, int32_t chunkX, int32_t chunkZ);
 void sendResourcePacks(ClientConnection& client);
 void sendRemoveResourcePacks(ClientConnection& client, const std::vector<std::string>& uuidsToRemove = {});
 bool sendKeepAlivePacket(ClientConnection& client);
 void sendEntityMetadataPacket(const std::vector<MetadataEntry>& metadataEntries, int32_t entityID);
-void sendEntityMetadataPacket(const std::shared_ptr<Player>& player, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID);
+void sendEntityMetadataPacket(ClientConnection& client, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID);
 void sendEntityAnimation(const std::shared_ptr<Player> & player, EntityAnimation animation);
 void sendAcknowledgeBlockChange(ClientConnection& client, size_t sequenceID);
-void sendEquipmentPacket(const std::shared_ptr<Player> & player, int32_t entityID, const EquipmentSlot& slot);
+void sendEquipmentPacket(int32_t entityID, const EquipmentSlot& slot);
 void broadcastPlayerChatMessage(const std::shared_ptr<Player>& sender, const std::string& message, long timestamp, long salt, const std::vector<uint8_t>* signature, const RegistryManager& registryManager, const std::string& chatTypeIdentifier = "minecraft:chat", const std::string& targetName = "");
 void sendCommandsPacket(ClientConnection& client);
 void sendFinishConfigurationPacket(ClientConnection& client);
@@ -67,6 +75,7 @@ void sendServerPluginMessages(ClientConnection & client);
 void sendReInitializeWorldBorder(double x, double z, double size, int64_t speed, int32_t warningBlocks, int32_t warningTime);
 void sendInitializeWorldBorder(ClientConnection& client, const WorldBorder& border);
 void sendTimeUpdatePacket(ClientConnection& client);
+void sendTimeUpdate();
 void sendSetBorderCenter(double x, double z);
 void sendSetBorderLerpSize(double newDiameter, int64_t speed);
 void sendSetBorderSize(double newDiameter);
@@ -75,7 +84,6 @@ void sendSetBorderWarningDistance(int32_t warningBlocks);
 void sendBossbar(Bossbar& bossbar, int32_t action);
 void sendCommandSuggestionsResponse(ClientConnection& client, int32_t transactionID, const std::vector<std::string>& suggestions, int32_t start);
 void sendBundleDelimiter(ClientConnection& client);
-void sendBundleDelimiter();
 void sendEntityVelocity(const std::shared_ptr<Entity>& entity);
 void sendPickUpItem(const std::shared_ptr<Entity>& collectedEntity, const std::shared_ptr<Entity>& collectorEntity, int8_t count);
 void SendSetContainerSlot(ClientConnection& client, int8_t windowID, int32_t stateID, uint16_t slotID, const SlotData& slot);
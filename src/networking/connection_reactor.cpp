@@ -0,0 +1,414 @@
+#include "connection_reactor.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ranges>
+#include <string>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#ifndef _WIN32
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "client.h"
+#include "core/utils.h"
+#include "utils/thread_pool.h"
+
+// Upper bound for a blocking wait, even without a pending timer
+constexpr int MAX_POLL_WAIT_MS = 1000;
+// Wake-up interval of the portable poll() loop, which has no wake descriptor
+constexpr int POLL_FALLBACK_TIMEOUT_MS = 50;
+constexpr size_t SOCKET_READ_CHUNK = 16384;
+// Unparsed bytes a connection may hold: one incomplete packet with its length prefix, plus the chunk being read.
+// Only a client that keeps sending while its packets aren't being parsed gets there.
+constexpr size_t MAX_INBOUND_BUFFERED = MAX_PACKET_LENGTH + 3 + SOCKET_READ_CHUNK;
+
+static bool socketWouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+static void closeClientSocket(SocketType socket) {
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+ConnectionReactor::~ConnectionReactor() {
+    stop();
+}
+
+void ConnectionReactor::start(size_t threadCount) {
+    if (running.exchange(true)) {
+        return;
+    }
+    threadCount = std::max<size_t>(1, threadCount);
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        auto io = std::make_unique<IoThread>();
+        io->index = i;
+#ifdef __linux__
+        io->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        io->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (io->epollFd == -1 || io->wakeFd == -1) {
+            logMessage("Failed to create epoll instance: " + std::string(strerror(errno)), LOG_ERROR);
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = io->wakeFd;
+        epoll_ctl(io->epollFd, EPOLL_CTL_ADD, io->wakeFd, &event);
+#endif
+        ioThreads.push_back(std::move(io));
+    }
+
+    for (const auto& io : ioThreads) {
+        io->thread = std::thread(&ConnectionReactor::run, this, std::ref(*io));
+        std::string threadName = "IoThread:" + std::to_string(io->index);
+        set_thread_name(io->thread, threadName.data());
+    }
+
+    logMessage("Started " + std::to_string(threadCount) + " network I/O threads", LOG_DEBUG);
+}
+
+void ConnectionReactor::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    for (const auto& io : ioThreads) {
+        wake(*io);
+    }
+    for (const auto& io : ioThreads) {
+        if (io->thread.joinable()) {
+            io->thread.join();
+        }
+        for (const auto& client : io->connections | std::views::values) {
+            std::lock_guard lock(client->sendMutex);
+            client->connectionClosed = true;
+            closeClientSocket(client->socket);
+        }
+        io->connections.clear();
+#ifdef __linux__
+        close(io->epollFd);
+        close(io->wakeFd);
+#endif
+    }
+    ioThreads.clear();
+}
+
+void ConnectionReactor::addConnection(SocketType socket) {
+    if (!running || ioThreads.empty()) {
+        closeClientSocket(socket);
+        return;
+    }
+
+    // Spread connections evenly over the I/O threads
+    IoThread& io = *ioThreads[nextThread++ % ioThreads.size()];
+    {
+        std::lock_guard lock(io.taskMutex);
+        io.pendingTasks.emplace_back([this, &io, socket]() {
+            registerConnection(io, socket);
+        });
+    }
+    wake(io);
+}
+
+void ConnectionReactor::post(const std::shared_ptr<ClientConnection>& client, std::function<void()> task) {
+    if (!running || client->ioThread >= ioThreads.size()) {
+        return;
+    }
+
+    IoThread& io = *ioThreads[client->ioThread];
+    {
+        std::lock_guard lock(io.taskMutex);
+        io.pendingTasks.emplace_back([client, task = std::move(task)]() {
+            // The connection may have been closed while the task was queued
+            if (!client->connectionClosed) {
+                task();
+                flushPackets(*client);
+            }
+        });
+    }
+    wake(io);
+}
+
+void ConnectionReactor::flushAll() {
+    for (const auto& io : ioThreads) {
+        if (!io->flushRequested.exchange(true)) {
+            wake(*io);
+        }
+    }
+}
+
+void ConnectionReactor::wake(IoThread& io) {
+#ifdef __linux__
+    uint64_t value = 1;
+    if (write(io.wakeFd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+        logMessage("Failed to wake I/O thread: " + std::string(strerror(errno)), LOG_WARNING);
+    }
+#endif
+}
+
+void ConnectionReactor::runPendingTasks(IoThread& io) {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard lock(io.taskMutex);
+        tasks.swap(io.pendingTasks);
+    }
+
+    for (auto& task : tasks) {
+        try {
+            task();
+        } catch (const std::exception& e) {
+            logMessage("Error in I/O thread task: " + std::string(e.what()), LOG_ERROR);
+        }
+    }
+}
+
+void ConnectionReactor::registerConnection(IoThread& io, SocketType socket) {
+    auto client = std::make_shared<ClientConnection>();
+    client->socket = socket;
+    client->state = ClientState::Handshake;
+    client->ioThread = io.index;
+    client->lastActivity = std::chrono::steady_clock::now();
+
+    // Packets are already coalesced by the outbound queue, don't let Nagle delay them further
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+#ifdef _WIN32
+    // Reads and writes must never block the I/O thread; elsewhere they pass MSG_DONTWAIT instead
+    u_long nonBlocking = 1;
+    if (ioctlsocket(socket, FIONBIO, &nonBlocking) == SOCKET_ERROR) {
+        logMessage("Failed to make client socket non-blocking: " + std::to_string(WSAGetLastError()), LOG_ERROR);
+        closeClientSocket(socket);
+        return;
+    }
+#endif
+
+#ifdef __linux__
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.fd = socket;
+    if (epoll_ctl(io.epollFd, EPOLL_CTL_ADD, socket, &event) == -1) {
+        logMessage("Failed to register client socket: " + std::string(strerror(errno)), LOG_ERROR);
+        closeClientSocket(socket);
+        return;
+    }
+#endif
+
+    scheduleTimer(io, client, client->lastActivity);
+    io.connections[socket] = std::move(client);
+}
+
+void ConnectionReactor::run(IoThread& io) {
+    using namespace std::chrono;
+#ifdef __linux__
+    std::array<epoll_event, 256> events{};
+#else
+    std::vector<pollfd> pollFds;
+    std::vector<std::shared_ptr<ClientConnection>> polledClients;
+#endif
+
+    while (running) {
+        runPendingTasks(io);
+        if (io.flushRequested.exchange(false)) {
+            flushConnections(io);
+        }
+
+#ifdef __linux__
+        // Sleep until the next timer is due
+        auto now = steady_clock::now();
+        auto waitUntil = std::min(io.timers.nextExpiry(), now + milliseconds(MAX_POLL_WAIT_MS));
+        int timeout = static_cast<int>(std::max<int64_t>(0, ceil<milliseconds>(waitUntil - now).count()));
+        int eventCount = epoll_wait(io.epollFd, events.data(), static_cast<int>(events.size()), timeout);
+        if (eventCount == -1 && errno != EINTR) {
+            logMessage("epoll_wait failed: " + std::string(strerror(errno)), LOG_ERROR);
+            break;
+        }
+
+        for (int i = 0; i < eventCount; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == io.wakeFd) {
+                uint64_t value;
+                while (read(io.wakeFd, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+
+            auto it = io.connections.find(fd);
+            if (it == io.connections.end()) {
+                continue;
+            }
+            // Keep the connection alive while it is being serviced
+            std::shared_ptr<ClientConnection> client = it->second;
+            if (events[i].events & EPOLLOUT) {
+                // Socket buffer drained, continue with the rest of the queue
+                flushPackets(*client);
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                readFromClient(io, client);
+            }
+        }
+#else
+        // Level-triggered fallback for platforms without epoll
+        pollFds.clear();
+        polledClients.clear();
+        for (const auto& client : io.connections | std::views::values) {
+            short pollEvents = client->outboundBytes > 0 ? POLLIN | POLLOUT : POLLIN;
+            pollFds.push_back({client->socket, pollEvents, 0});
+            polledClients.push_back(client);
+        }
+
+        if (pollFds.empty()) {
+            std::this_thread::sleep_for(milliseconds(POLL_FALLBACK_TIMEOUT_MS));
+        } else {
+#ifdef _WIN32
+            int ready = WSAPoll(pollFds.data(), static_cast<ULONG>(pollFds.size()), POLL_FALLBACK_TIMEOUT_MS);
+#else
+            int ready = poll(pollFds.data(), pollFds.size(), POLL_FALLBACK_TIMEOUT_MS);
+#endif
+            for (size_t i = 0; ready > 0 && i < pollFds.size(); ++i) {
+                if (pollFds[i].revents & POLLOUT) {
+                    flushPackets(*polledClients[i]);
+                }
+                if (pollFds[i].revents & ~POLLOUT) {
+                    readFromClient(io, polledClients[i]);
+                }
+            }
+        }
+#endif
+
+        io.timers.advance(steady_clock::now());
+    }
+}
+
+void ConnectionReactor::readFromClient(IoThread& io, const std::shared_ptr<ClientConnection>& client) {
+    std::span<const uint8_t> packet;
+    bool keepOpen = true;
+
+    while (keepOpen) {
+        if (client->inbound.size() >= MAX_INBOUND_BUFFERED) {
+            logMessage("Client sent more data than can be buffered, disconnecting", LOG_WARNING);
+            keepOpen = false;
+            break;
+        }
+
+        // Receive straight into the connection's ring buffer
+        std::span<uint8_t> space = client->inbound.prepareWrite(SOCKET_READ_CHUNK);
+        size_t readLength = std::min(space.size(), MAX_INBOUND_BUFFERED - client->inbound.size());
+#ifdef _WIN32
+        int received = recv(client->socket, reinterpret_cast<char*>(space.data()), static_cast<int>(readLength), 0);
+#else
+        ssize_t received = recv(client->socket, space.data(), readLength, MSG_DONTWAIT);
+#endif
+        if (received < 0 && socketWouldBlock()) {
+            break;
+        }
+#ifndef _WIN32
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (received <= 0) {
+            // Orderly shutdown or socket error
+            keepOpen = false;
+            break;
+        }
+
+        if (!commitInbound(*client, static_cast<size_t>(received))) {
+            keepOpen = false;
+            break;
+        }
+        client->lastActivity = std::chrono::steady_clock::now();
+
+        // Frame and dispatch every complete packet received so far
+        try {
+            while (keepOpen && !client->inboundPaused) {
+                FrameResult result = nextBufferedPacket(*client, packet);
+                if (result == FrameResult::Incomplete) {
+                    break;
+                }
+                keepOpen = result == FrameResult::Packet && handleIncomingPacket(client, packet);
+            }
+        } catch (const std::exception& e) {
+            logMessage("Client disconnected with error: " + std::string(e.what()), LOG_ERROR);
+            keepOpen = false;
+        }
+
+#ifndef __linux__
+        // Level-triggered: the next poll() reports whatever is left
+        break;
+#endif
+    }
+
+    if (keepOpen) {
+        // Replies to the packets just handled go out right away
+        keepOpen = flushPackets(*client);
+    }
+    if (!keepOpen) {
+        closeConnection(io, client);
+    }
+}
+
+void ConnectionReactor::closeConnection(IoThread& io, const std::shared_ptr<ClientConnection>& client) {
+    if (io.connections.erase(client->socket) == 0) {
+        return;
+    }
+    io.timers.cancel(client->timerID);
+#ifdef __linux__
+    epoll_ctl(io.epollFd, EPOLL_CTL_DEL, client->socket, nullptr);
+#endif
+
+    // Best effort, e.g. the pong of a status request
+    flushPackets(*client);
+    handleClientClosed(client);
+
+    // Senders on other threads check connectionClosed under the send mutex,
+    // so nobody writes to the descriptor once it can be reused
+    std::lock_guard lock(client->sendMutex);
+    client->connectionClosed = true;
+    closeClientSocket(client->socket);
+}
+
+void ConnectionReactor::flushConnections(IoThread& io) {
+    std::vector<std::shared_ptr<ClientConnection>> failed;
+    for (const auto& client : io.connections | std::views::values) {
+        if (client->outboundBytes > 0 && !flushPackets(*client)) {
+            failed.push_back(client);
+        }
+    }
+
+    for (const auto& client : failed) {
+        closeConnection(io, client);
+    }
+}
+
+void ConnectionReactor::scheduleTimer(IoThread& io, const std::shared_ptr<ClientConnection>& client, std::chrono::steady_clock::time_point deadline) {
+    std::weak_ptr<ClientConnection> weakClient = client;
+    client->timerID = io.timers.schedule(deadline, [this, &io, weakClient]() {
+        if (std::shared_ptr<ClientConnection> client = weakClient.lock()) {
+            runTimer(io, client);
+        }
+    });
+}
+
+void ConnectionReactor::runTimer(IoThread& io, const std::shared_ptr<ClientConnection>& client) {
+    // Each connection has exactly one pending timer, set to its earliest deadline
+    std::chrono::steady_clock::time_point nextCheck;
+    if (!checkClientTimers(*client, std::chrono::steady_clock::now(), nextCheck)) {
+        closeConnection(io, client);
+        return;
+    }
+    scheduleTimer(io, client, nextCheck);
+}
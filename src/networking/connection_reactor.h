@@ -0,0 +1,72 @@
+#ifndef CONNECTION_REACTOR_H
+#define CONNECTION_REACTOR_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "network.h"
+#include "utils/timer_wheel.h"
+
+struct ClientConnection;
+
+// Multiplexes every client socket over a small, fixed set of I/O threads.
+// Each connection is pinned to one thread which owns its inbound state machine.
+class ConnectionReactor {
+public:
+    ConnectionReactor() = default;
+    ~ConnectionReactor();
+
+    void start(size_t threadCount);
+    void stop();
+
+    // Hand an accepted socket over to one of the I/O threads
+    void addConnection(SocketType socket);
+
+    // Run a task on the I/O thread that owns the connection
+    void post(const std::shared_ptr<ClientConnection>& client, std::function<void()> task);
+
+    // Ask every I/O thread to write out the queued packets of its connections
+    void flushAll();
+
+    size_t getThreadCount() const { return ioThreads.size(); }
+
+private:
+    struct IoThread {
+        size_t index = 0;
+        std::thread thread;
+#ifdef __linux__
+        int epollFd = -1;
+        int wakeFd = -1;
+#endif
+        // Tasks posted from other threads
+        std::mutex taskMutex;
+        std::vector<std::function<void()>> pendingTasks;
+        std::atomic<bool> flushRequested{false};
+
+        // Only touched by the owning thread
+        std::unordered_map<SocketType, std::shared_ptr<ClientConnection>> connections;
+        // Keep-alive, timeout and stall deadlines of the connections
+        TimerWheel timers;
+    };
+
+    void run(IoThread& io);
+    void wake(IoThread& io);
+    void runPendingTasks(IoThread& io);
+    void registerConnection(IoThread& io, SocketType socket);
+    void readFromClient(IoThread& io, const std::shared_ptr<ClientConnection>& client);
+    void closeConnection(IoThread& io, const std::shared_ptr<ClientConnection>& client);
+    void flushConnections(IoThread& io);
+    void scheduleTimer(IoThread& io, const std::shared_ptr<ClientConnection>& client, std::chrono::steady_clock::time_point deadline);
+    void runTimer(IoThread& io, const std::shared_ptr<ClientConnection>& client);
+
+    std::vector<std::unique_ptr<IoThread>> ioThreads;
+    std::atomic<size_t> nextThread{0};
+    std::atomic<bool> running{false};
+};
+
+#endif // CONNECTION_REACTOR_H
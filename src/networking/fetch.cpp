@@ -1,17 +1,27 @@
 #include "fetch.h"
 
 #include "core/config.h"
+#include "core/server.h"
 #include "core/utils.h"
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 constexpr int MAX_RETRIES = 3;
 constexpr int RETRY_DELAY_MS = 1000; // 1 second
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <string>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include "cppcodec/base64_rfc4648.hpp"
 #include "../thirdparty/httplib.h"
+#include "utils/lru_cache.h"
+
+// Recent lookups, failed lookups are not cached
+constexpr size_t PROFILE_CACHE_SIZE = 1024;
+static LruCache<std::string, std::string> uuidCache(PROFILE_CACHE_SIZE, std::chrono::hours(1));
+// Skins change more often than names
+static LruCache<std::string, std::pair<std::string, std::string>> texturesCache(PROFILE_CACHE_SIZE, std::chrono::minutes(10));
 
 std::vector<std::string> ca_paths = {
         "/etc/ssl/certs/ca-certificates.crt",               // Debian/Ubuntu/Gentoo etc.
@@ -22,24 +32,49 @@ std::vector<std::string> ca_paths = {
         "/etc/ssl/cert.pem",                                // Alpine Linux, macOS
 };
 
-std::string httpGet(const std::string& host, const std::string& path) {
-    httplib::SSLClient cli(host.c_str());
-
-#ifndef _WIN32
-    bool set_ca_cert = false;
-    for (const auto& path : ca_paths) {
-        if (access(path.c_str(), R_OK) == 0) {
-            cli.set_ca_cert_path(path.c_str());
-            set_ca_cert = true;
-            break;
+// Probed once, the CA bundle doesn't move while the server runs
+static const std::string& findCACertPath() {
+    static const std::string caPath = [] {
+        for (const auto& path : ca_paths) {
+            if (access(path.c_str(), R_OK) == 0) {
+                return path;
+            }
         }
-    }
-    if (!set_ca_cert) {
         logMessage("No CA certificates found on system. SSL connections may fail.", LOG_ERROR);
+        return std::string();
+    }();
+    return caPath;
+}
+
+template<typename Client>
+static void configureClient(Client& cli) {
+#ifndef _WIN32
+    if (!findCACertPath().empty()) {
+        cli.set_ca_cert_path(findCACertPath().c_str());
     }
     cli.enable_server_certificate_verification(true);
 #endif
     cli.set_follow_location(true);
+}
+
+// One client per session worker, so the TLS connection is reused across logins
+static httplib::Client& getSessionClient() {
+    thread_local std::unique_ptr<httplib::Client> sessionClient;
+    if (!sessionClient) {
+        sessionClient = std::make_unique<httplib::Client>(serverConfig.sessionServerUrl);
+        configureClient(*sessionClient);
+        sessionClient->set_keep_alive(true);
+        auto timeout = std::chrono::milliseconds(serverConfig.sessionTimeoutMs);
+        sessionClient->set_connection_timeout(timeout);
+        sessionClient->set_read_timeout(timeout);
+        sessionClient->set_write_timeout(timeout);
+    }
+    return *sessionClient;
+}
+
+std::string httpGet(const std::string& host, const std::string& path) {
+    httplib::SSLClient cli(host.c_str());
+    configureClient(cli);
 
     auto res = cli.Get(path.c_str());
 
@@ -52,6 +87,13 @@ std::string httpGet(const std::string& host, const std::string& path) {
 }
 
 std::string fetchPlayerUUID(const std::string& name) {
+    // Names are case-insensitive
+    std::string key = name;
+    std::ranges::transform(key, key.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (auto cached = uuidCache.get(key)) {
+        return *cached;
+    }
+
     std::string host = "api.mojang.com";
     std::string path = "/users/profiles/minecraft/" + name;
 
@@ -77,10 +119,16 @@ std::string fetchPlayerUUID(const std::string& name) {
         return "";
     }
 
-    return profileJson["id"];
+    std::string uuid = profileJson["id"];
+    uuidCache.put(key, uuid);
+    return uuid;
 }
 
 std::pair<std::string, std::string> fetchPlayerSkin(const std::string& uuid) {
+    if (auto cached = texturesCache.get(uuid)) {
+        return *cached;
+    }
+
     std::string host = "sessionserver.mojang.com";
     std::string path = "/session/minecraft/profile/" + uuid + "?unsigned=false";
 
@@ -108,7 +156,9 @@ std::pair<std::string, std::string> fetchPlayerSkin(const std::string& uuid) {
 
     for (const auto& prop : profileJson["properties"]) {
         if (prop["name"] == "textures" && prop.contains("value")) {
-            return { prop["value"], prop["signature"] };
+            std::pair<std::string, std::string> textures = { prop["value"], prop["signature"] };
+            texturesCache.put(uuid, textures);
+            return textures;
         }
     }
 
@@ -151,64 +201,58 @@ std::string extractSkinURL(const std::string& texturesBase64) {
     return texturesJson["textures"]["SKIN"]["url"].get<std::string>();
 }
 
-bool authenticatePlayer(const std::string& username, const std::string& serverHash, const std::string& ipAddress, std::string& outUUID, std::string& outName, std::pair<std::string, std::string>& skinTexturesPair) {
-    httplib::Client sessionClient("sessionserver.mojang.com");
+// Parses the id, name and textures of a hasJoined or profile response
+static bool parseSessionProfile(const std::string& body, SessionProfile& profile) {
+    // Filled in completely or not at all
+    SessionProfile parsed = profile;
+    try {
+        nlohmann::json responseJson = nlohmann::json::parse(body);
+        if (!responseJson.contains("id") || !responseJson.contains("name")) {
+            logMessage("No UUID or name found in session server response.", LOG_ERROR);
+            return false;
+        }
 
-    std::string endpoint = "/session/minecraft/hasJoined?username=" + httplib::detail::encode_query_param(username) + "&serverId=" + httplib::detail::encode_query_param(serverHash);
+        parsed.uuid = responseJson["id"].get<std::string>();
+        parsed.name = responseJson["name"].get<std::string>();
 
-#ifndef _WIN32
-    bool set_ca_cert = false;
-    for (const auto& path : ca_paths) {
-        if (access(path.c_str(), R_OK) == 0) {
-            sessionClient.set_ca_cert_path(path.c_str());
-            set_ca_cert = true;
-            break;
+        for (const auto& prop : responseJson.value("properties", nlohmann::json::array())) {
+            if (prop.value("name", "") == "textures" && prop.contains("value") && prop.contains("signature")) {
+                parsed.textures = { prop["value"].get<std::string>(), prop["signature"].get<std::string>() };
+            }
         }
+    } catch (const nlohmann::json::exception& e) {
+        // Malformed JSON, or fields of the wrong type
+        logMessage("Invalid session server response: " + std::string(e.what()), LOG_ERROR);
+        return false;
     }
-    if (!set_ca_cert) {
-        logMessage("No CA certificates fouifnd on system. SSL connections may fail.", LOG_ERROR);
-    }
-    sessionClient.enable_server_certificate_verification(true);
-#endif
-    sessionClient.set_follow_location(true);
+    profile = std::move(parsed);
+    return true;
+}
+
+static SessionProfile querySession(const std::string& username, const std::string& serverHash) {
+    SessionProfile profile;
+    httplib::Client& sessionClient = getSessionClient();
+    std::string endpoint = "/session/minecraft/hasJoined?username=" + httplib::detail::encode_query_param(username) + "&serverId=" + httplib::detail::encode_query_param(serverHash);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(serverConfig.sessionTimeoutMs);
 
     for (int tryCount = 0; tryCount < MAX_RETRIES; ++tryCount) {
-        auto res = sessionClient.Get(endpoint.c_str());
+        auto res = sessionClient.Get(endpoint);
 
         if (res && res->status == 200) {
-            // Parse JSON response
-            nlohmann::json responseJson;
-            try {
-                responseJson = nlohmann::json::parse(res->body);
-            } catch (const nlohmann::json::parse_error& e) {
-                logMessage("JSON parse error for authentication response: " + std::string(e.what()), LOG_ERROR);
-                return false;
-            }
-
-            if (!responseJson.contains("id") || !responseJson.contains("name")) {
-                logMessage("No UUID or name found in authentication response.", LOG_ERROR);
-                return false;
-            }
-
-            outUUID = responseJson["id"];
-            outName = responseJson["name"];
-
-            for (const auto& prop : responseJson["properties"]) {
-                if (prop["name"] == "textures" && prop.contains("value") && prop.contains("signature")) {
-                    skinTexturesPair = { prop["value"], prop["signature"] };
-                }
-            }
-            return true;
+            profile.authenticated = parseSessionProfile(res->body, profile);
+            return profile;
         }
         if (res && res->status == 204) {
             // 204 No Content: Authentication failed
             logMessage("Authentication failed for player " + username + ": 204 No Content", LOG_ERROR);
-            if (tryCount < MAX_RETRIES - 1) {
+            // Only retry while the login timeout allows it
+            auto retryAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(RETRY_DELAY_MS);
+            if (tryCount < MAX_RETRIES - 1 && retryAt < deadline) {
                 logMessage("Retrying authentication (" + std::to_string(tryCount + 1) + "/" + std::to_string(MAX_RETRIES) + ")...", LOG_ERROR);
-                std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_DELAY_MS));
+                std::this_thread::sleep_until(retryAt);
                 continue; // Retry the loop
             }
-            return false;
+            return profile;
         }
         if (res && res->status == 403) {
             // 403 Forbidden: Player has multiplayer disabled or is banned
@@ -218,24 +262,72 @@ bool authenticatePlayer(const std::string& username, const std::string& serverHa
             } catch (...) {
                 logMessage("Authentication Error: 403 Forbidden", LOG_ERROR);
             }
-            return false;
+            return profile;
         }
         // Handle other HTTP statuses
         if (res) {
             logMessage("Authentication failed for player " + username + ". HTTP Status: " + std::to_string(res->status), LOG_ERROR);
         } else {
-            logMessage("Authentication request failed: No response from session server.", LOG_ERROR);
+            logMessage("Authentication request failed: " + httplib::to_string(res.error()), LOG_ERROR);
         }
-        return false;
+        return profile;
     }
 
     // If all retries are exhausted
     logMessage("Authentication failed for player " + username + " after " + std::to_string(MAX_RETRIES) + " attempts.", LOG_ERROR);
-    return false;
+    return profile;
+}
+
+static std::pair<std::string, std::string> queryProfileTextures(const std::string& uuid) {
+    if (auto cached = texturesCache.get(uuid)) {
+        return *cached;
+    }
+
+    auto res = getSessionClient().Get("/session/minecraft/profile/" + uuid + "?unsigned=false");
+    if (!res || res->status != 200) {
+        logMessage("Failed to fetch profile for UUID: " + uuid, LOG_ERROR);
+        return { "", "" };
+    }
+
+    SessionProfile profile;
+    if (parseSessionProfile(res->body, profile) && !profile.textures.first.empty()) {
+        texturesCache.put(uuid, profile.textures);
+    }
+    return profile.textures;
+}
+
+void authenticatePlayerAsync(const std::string& username, const std::string& serverHash, std::function<void(const SessionProfile&)> callback) {
+    sessionPool->enqueue([username, serverHash, callback = std::move(callback)]() {
+        // The callback always runs, the login would otherwise hang until it times out
+        SessionProfile profile;
+        try {
+            profile = querySession(username, serverHash);
+            if (profile.authenticated && (profile.textures.first.empty() || profile.textures.second.empty())) {
+                profile.textures = queryProfileTextures(profile.uuid);
+            } else if (profile.authenticated) {
+                // Fresh from hasJoined, good for later skin lookups too
+                texturesCache.put(profile.uuid, profile.textures);
+            }
+        } catch (const std::exception& e) {
+            logMessage("Authentication failed for player " + username + ": " + e.what(), LOG_ERROR);
+            profile = SessionProfile{};
+        }
+        callback(profile);
+    });
+}
+
+void fetchPlayerSkinAsync(const std::string& uuid, std::function<void(const std::pair<std::string, std::string>&)> callback) {
+    sessionPool->enqueue([uuid, callback = std::move(callback)]() {
+        callback(queryProfileTextures(uuid));
+    });
 }
 
 std::vector<std::string> fetchMojangPublicKeys() {
     httplib::Client cli("https://api.minecraftservices.com");
+    configureClient(cli);
+    auto timeout = std::chrono::milliseconds(serverConfig.sessionTimeoutMs);
+    cli.set_connection_timeout(timeout);
+    cli.set_read_timeout(timeout);
     auto res = cli.Get("/publickeys");
 
     if (!res || res->status != 200) {
@@ -244,15 +336,20 @@ std::vector<std::string> fetchMojangPublicKeys() {
         return {};
     }
 
-    // Parse JSON response
-    nlohmann::json jsonResponse = nlohmann::json::parse(res->body);
-
     std::vector<std::string> publicKeys;
-    for (const auto &keyObj : jsonResponse["playerCertificateKeys"]) {
-        publicKeys.push_back(keyObj["publicKey"].get<std::string>());
-    }
-    for (const auto &keyObj : jsonResponse["profilePropertyKeys"]) {
-        publicKeys.push_back(keyObj["publicKey"].get<std::string>());
+    try {
+        // Parse JSON response
+        nlohmann::json jsonResponse = nlohmann::json::parse(res->body);
+
+        for (const auto &keyObj : jsonResponse["playerCertificateKeys"]) {
+            publicKeys.push_back(keyObj["publicKey"].get<std::string>());
+        }
+        for (const auto &keyObj : jsonResponse["profilePropertyKeys"]) {
+            publicKeys.push_back(keyObj["publicKey"].get<std::string>());
+        }
+    } catch (const nlohmann::json::exception& e) {
+        logMessage("JSON parse error for Mojang public keys: " + std::string(e.what()), LOG_ERROR);
+        return {};
     }
 
     return publicKeys;
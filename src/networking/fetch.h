@@ -1,10 +1,19 @@
 #ifndef FETCH_H
 #define FETCH_H
+#include <functional>
 #include <string>
 #include <vector>
 
 struct ResourcePack;
 
+// Profile returned by the session server
+struct SessionProfile {
+    bool authenticated = false;
+    std::string uuid;
+    std::string name;
+    std::pair<std::string, std::string> textures; // value, signature
+};
+
 struct ParsedURL {
     std::string protocol;
     std::string host;
@@ -15,7 +24,11 @@ struct ParsedURL {
 std::string fetchPlayerUUID(const std::string& name);
 std::pair<std::string, std::string> fetchPlayerSkin(const std::string& uuid);
 std::string extractSkinURL(const std::string& texturesBase64);
-bool authenticatePlayer(const std::string& username, const std::string& serverHash, const std::string& ipAddress, std::string& outUUID, std::string& outName, std::pair<std::string, std::string>& skinTexturesPair);
+
+// Session server requests run on a small pool of workers that each keep a connection alive.
+// The callbacks are invoked on that worker thread.
+void authenticatePlayerAsync(const std::string& username, const std::string& serverHash, std::function<void(const SessionProfile&)> callback);
+void fetchPlayerSkinAsync(const std::string& uuid, std::function<void(const std::pair<std::string, std::string>&)> callback);
 std::vector<std::string> fetchMojangPublicKeys();
 bool validateResourcePackURL(const ResourcePack& pack);
 bool downloadResourcePack(const ResourcePack& pack, const std::string& downloadPath);
@@ -1,8 +1,12 @@
 #include "network.h"
+#include <array>
 #include <cstring>
 #include <random>
+#include <stdexcept>
 #ifdef _WIN32
 #include <ws2tcpip.h>
+#else
+#include <sys/uio.h>
 #endif
 #include <openssl/err.h>
 #include <openssl/evp.h>
@@ -10,27 +14,7 @@
 #include "client.h"
 #include "core/config.h"
 #include "core/server.h"
-
-int32_t readVarInt(SocketType sock) {
-    int32_t numRead = 0;
-    int32_t result = 0;
-    uint8_t readByte;
-    do {
-        int recvResult = recv(sock, reinterpret_cast<char*>(&readByte), 1, 0);
-        if (recvResult <= 0) {
-            return -1;
-        }
-        int32_t value = (readByte & 0b01111111);
-        result |= (value << (7 * numRead));
-
-        numRead++;
-        if (numRead > 5) {
-            return -1;
-        }
-    } while ((readByte & 0b10000000) != 0);
-
-    return result;
-}
+#include "packet_stats.h"
 
 void logicalShiftRightAssign(int32_t& value, int shift) {
     // Cast to unsigned to perform logical shift
@@ -137,7 +121,7 @@ void writeUUID(std::vector<uint8_t>& buffer, const std::array<uint8_t, 16>& uuid
     }
 }
 
-int32_t parseVarInt(const std::vector<uint8_t>& data, size_t& index) {
+int32_t parseVarInt(std::span<const uint8_t> data, size_t& index) {
     int32_t value = 0;
     int32_t position = 0;
 
@@ -159,7 +143,7 @@ int32_t parseVarInt(const std::vector<uint8_t>& data, size_t& index) {
     return value;
 }
 
-int64_t parseLong(const std::vector<uint8_t>& data, size_t& index) {
+int64_t parseLong(std::span<const uint8_t> data, size_t& index) {
     if (index + 8 > data.size()) {
         // Error: Not enough data
         return 0;
@@ -174,7 +158,7 @@ int64_t parseLong(const std::vector<uint8_t>& data, size_t& index) {
     return value;
 }
 
-short parseShort(const std::vector<uint8_t>& data, size_t& index) {
+short parseShort(std::span<const uint8_t> data, size_t& index) {
     if (index + 2 > data.size()) {
         // Error: Not enough data
         return 0;
@@ -185,7 +169,7 @@ short parseShort(const std::vector<uint8_t>& data, size_t& index) {
     return value;
 }
 
-float parseFloat(const std::vector<uint8_t>& data, size_t& index) {
+float parseFloat(std::span<const uint8_t> data, size_t& index) {
     if (index + 4 > data.size()) {
         // Error: Not enough data
         return 0.0f;
@@ -198,7 +182,7 @@ float parseFloat(const std::vector<uint8_t>& data, size_t& index) {
     return result;
 }
 
-double parseDouble(const std::vector<uint8_t>& data, size_t& index) {
+double parseDouble(std::span<const uint8_t> data, size_t& index) {
     if (index + 8 > data.size()) {
         // Error: Not enough data
         return 0.0;
@@ -215,14 +199,18 @@ double parseDouble(const std::vector<uint8_t>& data, size_t& index) {
     return result;
 }
 
-std::string parseString(const std::vector<uint8_t>& data, size_t& index) {
+std::string parseString(std::span<const uint8_t> data, size_t& index) {
     int32_t length = parseVarInt(data, index);
+    // The packet views point into the connection's ring buffer, a bad length must not read past the packet
+    if (length < 0 || static_cast<size_t>(length) > data.size() - index) {
+        throw std::out_of_range("String length " + std::to_string(length) + " at offset " + std::to_string(index) + " exceeds the packet of " + std::to_string(data.size()));
+    }
     std::string result(data.begin() + index, data.begin() + index + length);
     index += length;
     return result;
 }
 
-std::vector<uint8_t> parseBytes(const std::vector<uint8_t>& data, size_t& index, size_t length) {
+std::vector<uint8_t> parseBytes(std::span<const uint8_t> data, size_t& index, size_t length) {
     if (index + length > data.size()) {
         // Error: Not enough data
         return {};
@@ -233,7 +221,7 @@ std::vector<uint8_t> parseBytes(const std::vector<uint8_t>& data, size_t& index,
     return result;
 }
 
-uint64_t parseVarLong(const std::vector<uint8_t>& data, size_t& index) {
+uint64_t parseVarLong(std::span<const uint8_t> data, size_t& index) {
     int64_t value = 0;
     int32_t position = 0;
 
@@ -255,7 +243,7 @@ uint64_t parseVarLong(const std::vector<uint8_t>& data, size_t& index) {
     return value;
 }
 
-SlotData parseSlotData(const std::vector<uint8_t>& data, size_t& index) {
+SlotData parseSlotData(std::span<const uint8_t> data, size_t& index) {
     SlotData slot;
     slot.itemCount = parseVarInt(data, index);
     if (slot.itemCount == 0) {
@@ -279,331 +267,415 @@ SlotData parseSlotData(const std::vector<uint8_t>& data, size_t& index) {
     return slot;
 }
 
-uint8_t parseByte(const std::vector<uint8_t>& data, size_t& index) {
+uint8_t parseByte(std::span<const uint8_t> data, size_t& index) {
     if (index >= data.size()) {
-        // Error: Not enough data
-        return 0;
+        throw std::out_of_range("Packet too short: needed 1 byte at offset " + std::to_string(index) + " of " + std::to_string(data.size()));
     }
 
     return data[index++];
 }
 
-bool readUnencryptedPacket(const ClientConnection& client, std::vector<uint8_t>& packetData) {
-    // Read the length prefix (VarInt)
-    int32_t length = readVarInt(client.socket);
-    if (length == -1) {
-        // Connection closed or error
-        return false;
+constexpr int32_t MAX_UNCOMPRESSED_LENGTH = 8388608;
+
+bool decryptInbound(ClientConnection& client, size_t offset) {
+    if (!serverConfig.enableEncryption || !client.decryptCtx) {
+        return true;
     }
 
-    // Read the packet payload based on the length
-    packetData.resize(length);
-    size_t totalRead = 0;
-    while (totalRead < static_cast<size_t>(length)) {
-        ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(packetData.data()) + totalRead, length - totalRead, 0);
-        if (bytesRead <= 0) {
-            // Connection closed or error
+    // AES/CFB8 is a stream mode, so everything received can be decrypted in place at once
+    auto [first, second] = client.inbound.readableSegments(offset);
+    for (std::span<uint8_t> segment : {first, second}) {
+        if (segment.empty()) {
+            continue;
+        }
+        int outLen = 0;
+        if (EVP_DecryptUpdate(client.decryptCtx, segment.data(), &outLen, segment.data(), static_cast<int>(segment.size())) != 1) {
+            logMessage("Failed to decrypt inbound data", LOG_ERROR);
+            ERR_print_errors_fp(stderr);
             return false;
         }
-        totalRead += bytesRead;
     }
-
     return true;
 }
 
-bool readPacketTimeout(const ClientConnection& client, std::vector<uint8_t>& packetData, int timeout, bool unencrypted) {
-    fd_set readSet;
-    FD_ZERO(&readSet);
-    FD_SET(client.socket, &readSet);
-
-    timeval tv;
-    tv.tv_sec = timeout;
-    tv.tv_usec = 0;
-
-    int selectResult = select(client.socket + 1, &readSet, nullptr, nullptr, &tv);
-    if (selectResult == -1) {
-        // Error occurred
-        return false;
-    }
-    if (selectResult == 0) {
-        // Timeout
-        return false;
-    }
-    if (unencrypted) {
-        return readUnencryptedPacket(client, packetData);
-    }
-    return readPacket(client, packetData);
+bool commitInbound(ClientConnection& client, size_t length) {
+    // The received bytes were written to the free space right after the unread data
+    size_t offset = client.inbound.size();
+    client.inbound.commitWrite(length);
+    return decryptInbound(client, offset);
 }
 
-bool readPacket(const ClientConnection& client, std::vector<uint8_t>& packetData) {
-    if (serverConfig.enableEncryption && client.decryptCtx) {
-        // Step 1: Read encrypted length prefix (VarInt up to 5 bytes)
-        int32_t length = 0;
-        int32_t numRead = 0;
-        uint8_t decryptedByte;
-        bool lengthRead = false;
-
-        while (numRead < 5 && !lengthRead) {
-            uint8_t encryptedByte;
-            ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(&encryptedByte), 1, 0);
-            if (bytesRead <= 0) {
-                // Connection closed or error
-                return false;
-            }
-
-            // Decrypt the byte
-            int outLen = 0;
-            if (EVP_DecryptUpdate(client.decryptCtx, &decryptedByte, &outLen, &encryptedByte, 1) != 1) {
-                logMessage("Failed to decrypt length byte", LOG_ERROR);
-                ERR_print_errors_fp(stderr);
-                return false;
-            }
+FrameResult nextBufferedPacket(ClientConnection& client, std::span<const uint8_t>& packet) {
+    RingBuffer& buffer = client.inbound;
+    size_t index = 0;
 
-            if (outLen != 1) {
-                logMessage("Unexpected decrypted length for length byte", LOG_ERROR);
-                return false;
-            }
-
-            // Accumulate the length
-            length |= (decryptedByte & 0x7F) << (7 * numRead);
-            if ((decryptedByte & 0x80) == 0) {
-                lengthRead = true;
-            }
-            numRead++;
-        }
-
-        if (!lengthRead) {
-            logMessage("VarInt length prefix is too big", LOG_ERROR);
-            return false;
-        }
-
-        // Step 2: Read encrypted payload based on the decrypted length
-        std::vector<uint8_t> encryptedPayload(length);
-        size_t totalRead = 0;
-        while (totalRead < static_cast<size_t>(length)) {
-            ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(encryptedPayload.data()) + totalRead, length - totalRead, 0);
-            if (bytesRead <= 0) {
-                // Connection closed or error
-                return false;
-            }
-            totalRead += bytesRead;
-        }
-
-        // Step 3: Decrypt the payload
-        std::vector<uint8_t> decryptedPayload(length);
-        int decryptedLen = 0;
-        if (EVP_DecryptUpdate(client.decryptCtx, decryptedPayload.data(), &decryptedLen, encryptedPayload.data(), length) != 1) {
-            logMessage("Failed to decrypt payload", LOG_ERROR);
-            ERR_print_errors_fp(stderr);
-            return false;
-        }
-        decryptedPayload.resize(decryptedLen);
-
-        // Assign the decrypted payload to packetData
-        packetData = decryptedPayload;
-
-        // Check for compression
-        if (client.compressionEnabled && serverConfig.enableCompression) {
-            size_t index = 0;
-            // Read the Data Length VarInt
-            int32_t dataLength = parseVarInt(decryptedPayload, index);
-
-            if (dataLength == 0) {
-                // Packet is not compressed
-                packetData = std::vector<uint8_t>(decryptedPayload.begin() + index, decryptedPayload.end());
-            } else {
-                // Packet is compressed
-                // Extract compressed data
-                std::vector<uint8_t> compressedData(decryptedPayload.begin() + index, decryptedPayload.end());
-
-                try {
-                    // Decompress data
-                    std::vector<uint8_t> decompressedData = decompressData(compressedData);
-
-                    // Replace packetData with decompressed data
-                    packetData = decompressedData;
-                } catch (const std::exception& e) {
-                    logMessage("Decompression failed: " + std::string(e.what()), LOG_ERROR);
-                    return false;
-                }
-            }
-        }
-
-        return true;
-    }
-    // Existing unencrypted readPacket logic
     // Read the length prefix (VarInt)
     int32_t length = 0;
     int32_t numRead = 0;
     uint8_t read;
     do {
-        ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(&read), 1, 0);
-        if (bytesRead <= 0) {
-            // Connection closed or error
-            return false;
+        if (index >= buffer.size()) {
+            return FrameResult::Incomplete;
         }
+        read = buffer.peek(index++);
         length |= (read & 0x7F) << (7 * numRead);
         numRead++;
-        if (numRead > 5) {
-            // VarInt is too big
+        if (numRead > 3 && (read & 0x80) != 0) {
             logMessage("VarInt is too big", LOG_ERROR);
-            return false;
+            return FrameResult::Error;
         }
     } while ((read & 0x80) != 0);
 
-    // Read the packet payload based on the length
-    std::vector<uint8_t> receivedData(length);
-    size_t totalRead = 0;
-    while (totalRead < static_cast<size_t>(length)) {
-        ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(receivedData.data()) + totalRead, length - totalRead, 0);
-        if (bytesRead <= 0) {
-            // Connection closed or error
-            return false;
-        }
-        totalRead += bytesRead;
+    if (length <= 0 || length > MAX_PACKET_LENGTH) {
+        logMessage("Invalid packet length: " + std::to_string(length), LOG_ERROR);
+        return FrameResult::Error;
+    }
+    if (buffer.size() - index < static_cast<size_t>(length)) {
+        return FrameResult::Incomplete;
+    }
+
+    // Point straight into the ring buffer unless the packet wraps around its end.
+    // Consuming only moves the read position, the bytes stay in place until the next receive.
+    std::span<uint8_t> first = buffer.readableSegments(index).first;
+    if (first.size() >= static_cast<size_t>(length)) {
+        packet = first.first(length);
+    } else {
+        client.framedPacket.resize(length);
+        buffer.copyOut(index, length, client.framedPacket.data());
+        packet = client.framedPacket;
     }
+    buffer.consume(index + length);
 
     // Check for compression
     if (client.compressionEnabled && serverConfig.enableCompression) {
-        size_t index = 0;
+        size_t dataIndex = 0;
         // Read the Data Length VarInt
-        int32_t dataLength = parseVarInt(receivedData, index);
+        int32_t dataLength = parseVarInt(packet, dataIndex);
 
         if (dataLength == 0) {
             // Packet is not compressed
-            packetData = std::vector<uint8_t>(receivedData.begin() + index, receivedData.end());
+            packet = packet.subspan(dataIndex);
         } else {
             // Packet is compressed
-            // Extract compressed data
-            std::vector<uint8_t> compressedData(receivedData.begin() + index, receivedData.end());
-
+            if (dataLength < 0 || dataLength > MAX_UNCOMPRESSED_LENGTH) {
+                logMessage("Invalid uncompressed packet length: " + std::to_string(dataLength), LOG_ERROR);
+                return FrameResult::Error;
+            }
             try {
-                // Decompress data
-                std::vector<uint8_t> decompressedData = decompressData(compressedData);
-
-                // Replace packetData with decompressed data
-                packetData = decompressedData;
+                decompressData(packet.data() + dataIndex, packet.size() - dataIndex, dataLength, client.inflatedPacket);
             } catch (const std::exception& e) {
                 logMessage("Decompression failed: " + std::string(e.what()), LOG_ERROR);
-                return false;
+                return FrameResult::Error;
             }
+            packet = client.inflatedPacket;
         }
-    } else {
-        // No compression; assign received data directly
-        packetData = receivedData;
     }
 
-    return true;
-}
-
-std::vector<uint8_t> buildPacket(const std::vector<uint8_t>& payload) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, static_cast<int32_t>(payload.size()));
-    packet.insert(packet.end(), payload.begin(), payload.end());
-    return packet;
-}
-
-std::vector<uint8_t> writeLength(const std::vector<uint8_t>& payload) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, static_cast<int32_t>(payload.size()));
-    return packet;
+    return FrameResult::Packet;
 }
 
-bool sendUnencryptedPacket(ClientConnection& client, const std::vector<uint8_t>& packetData) {
-    if (client.connectionClosed) {
-        return false;
+// Caller holds sendMutex. Writes as much of the queue as the socket accepts without blocking.
+static bool flushOutbound(ClientConnection& client) {
+    if (client.outboundQueue.empty()) {
+        return true;
     }
-    std::lock_guard lock(client.sendMutex);
-    std::vector<uint8_t> dataToSend = buildPacket(packetData);
-    size_t totalSent = 0;
-    size_t packetSize = dataToSend.size();
-    const char* dataPtr = reinterpret_cast<const char*>(dataToSend.data());
+    client.outboundFlushes++;
 
-    while (totalSent < packetSize) {
-        ssize_t sent = send(client.socket, dataPtr + totalSent, packetSize - totalSent, 0);
+    while (!client.outboundQueue.empty()) {
+#ifdef _WIN32
+        // Gather as many queued packets as possible into a single call, the socket is non-blocking
+        std::array<WSABUF, 64> buffers{};
+        size_t count = 0;
+        for (auto it = client.outboundQueue.begin(); it != client.outboundQueue.end() && count < buffers.size(); ++it, ++count) {
+            size_t skip = it->start + (count == 0 ? client.outboundOffset : 0);
+            buffers[count].buf = reinterpret_cast<char*>(it->bytes.data() + skip);
+            buffers[count].len = static_cast<ULONG>(it->bytes.size() - skip);
+        }
+        DWORD sent = 0;
+        if (WSASend(client.socket, buffers.data(), static_cast<DWORD>(count), &sent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+            int error = WSAGetLastError();
+            if (error == WSAEWOULDBLOCK) {
+                // Socket buffer is full, the I/O thread resumes once it drains
+                return true;
+            }
+            logMessage("Failed to send packet: " + std::to_string(error), LOG_DEBUG);
+            return false;
+        }
+#else
+        // Gather as many queued packets as possible into a single system call
+        std::array<iovec, 64> iov{};
+        size_t count = 0;
+        for (auto it = client.outboundQueue.begin(); it != client.outboundQueue.end() && count < iov.size(); ++it, ++count) {
+            size_t skip = it->start + (count == 0 ? client.outboundOffset : 0);
+            iov[count].iov_base = it->bytes.data() + skip;
+            iov[count].iov_len = it->bytes.size() - skip;
+        }
+        msghdr message{};
+        message.msg_iov = iov.data();
+        message.msg_iovlen = count;
+        int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+        flags |= MSG_NOSIGNAL;
+#endif
+        ssize_t sent = sendmsg(client.socket, &message, flags);
         if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Socket buffer is full, the I/O thread resumes once it drains
+                return true;
+            }
             logMessage("Failed to send packet: " + std::string(strerror(errno)), LOG_DEBUG);
             return false;
         }
-        totalSent += sent;
+#endif
+        // Drop the packets that went out completely
+        auto remaining = static_cast<size_t>(sent);
+        client.outboundBytes -= remaining;
+        while (remaining > 0) {
+            size_t left = client.outboundQueue.front().size() - client.outboundOffset;
+            if (remaining < left) {
+                client.outboundOffset += remaining;
+                break;
+            }
+            remaining -= left;
+            client.outboundQueue.pop_front();
+            client.outboundOffset = 0;
+            client.outboundPackets--;
+        }
     }
     return true;
 }
 
-bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData) {
-    if (client.connectionClosed) {
-        return false;
+// Caller holds sendMutex
+static bool queueOutbound(ClientConnection& client, FramedPacket&& frame) {
+    size_t queued = client.outboundBytes += frame.size();
+    client.outboundPackets++;
+    client.outboundQueue.push_back(std::move(frame));
+    if (queued > client.peakOutboundBytes) {
+        client.peakOutboundBytes = queued;
     }
-    std::lock_guard<std::mutex> lock(client.sendMutex);
-    std::vector<uint8_t> dataToSend;
 
-    // Determine if compression should be applied
-    bool shouldCompress = serverConfig.enableCompression &&
-                          packetData.size() >= serverConfig.compressionThreshold;
+    // Past the high-water mark the queue is drained right away instead of at the end of the tick
+    if (queued > static_cast<size_t>(serverConfig.outboundHighWaterMark)) {
+        return flushOutbound(client);
+    }
+    return true;
+}
 
-    if (shouldCompress && client.compressionEnabled) {
-        try {
-            // Compress the (Packet ID + Data)
-            std::vector<uint8_t> compressedData = compressData(packetData);
+bool flushPackets(ClientConnection& client) {
+    std::lock_guard lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return false;
+    }
+    return flushOutbound(client);
+}
 
-            // Create a new packet with Data Length (uncompressed size) + Compressed Data
-            std::vector<uint8_t> compressedPacket;
-            writeVarInt(compressedPacket, packetData.size()); // Data Length
-            compressedPacket.insert(compressedPacket.end(), compressedData.begin(), compressedData.end());
+void shutdownConnection(ClientConnection& client) {
+    std::lock_guard lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return;
+    }
+    // Push out whatever is still queued, e.g. a disconnect packet
+    flushOutbound(client);
+    // The owning I/O thread sees the hang-up and releases the connection
+#ifdef _WIN32
+    shutdown(client.socket, SD_BOTH);
+#else
+    shutdown(client.socket, SHUT_RDWR);
+#endif
+}
 
-            dataToSend = buildPacket(compressedPacket);
-        } catch (const std::exception& e) {
-            logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
-            return false;
+static size_t varIntSize(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+// Writes value as a VarInt ending right before position, returns where it starts
+static size_t prependVarInt(std::vector<uint8_t>& buffer, size_t position, int32_t value) {
+    auto remaining = static_cast<uint32_t>(value);
+    size_t start = position - varIntSize(remaining);
+    for (size_t i = start; i < position; ++i) {
+        auto byte = static_cast<uint8_t>(remaining & 0x7F);
+        remaining >>= 7;
+        buffer[i] = i + 1 < position ? byte | 0x80 : byte;
+    }
+    return start;
+}
+
+// Fills in the length prefix, plus the Data Length field once compression is enabled, in the space
+// reserved in front of the payload. Only compression past the threshold needs a second buffer.
+static size_t frameInPlace(std::vector<uint8_t>& buffer, bool compressionEnabled, CompressionProfile profile) {
+    size_t start = PacketWriter::HEADER_SPACE;
+    if (compressionEnabled) {
+        size_t payloadSize = buffer.size() - start;
+        if (serverConfig.enableCompression && payloadSize >= static_cast<size_t>(serverConfig.compressionThreshold)) {
+            // Data Length (uncompressed size) + compressed (Packet ID + Data)
+            int level = profile == CompressionProfile::Chunk ? serverConfig.chunkCompressionLevel : serverConfig.compressionLevel;
+            std::vector<uint8_t> compressed(PacketWriter::HEADER_SPACE);
+            compressData(buffer.data() + start, payloadSize, compressed, level);
+            buffer = std::move(compressed);
+            start = prependVarInt(buffer, start, static_cast<int32_t>(payloadSize));
+        } else {
+            // No compression: Data Length is 0
+            start = prependVarInt(buffer, start, 0);
         }
-    } else if (client.compressionEnabled) {
-        // No compression: Data Length is 0
-        std::vector<uint8_t> uncompressedPacket;
-        writeVarInt(uncompressedPacket, 0); // Data Length = 0
-        uncompressedPacket.insert(uncompressedPacket.end(), packetData.begin(), packetData.end());
-
-        // Build the final packet with length prefix
-        dataToSend = buildPacket(uncompressedPacket);
-    } else {
-        // No compression and compression not enabled
-        dataToSend = buildPacket(packetData);
     }
+    return prependVarInt(buffer, start, static_cast<int32_t>(buffer.size() - start));
+}
+
+static FramedPacket framePacket(std::span<const uint8_t> payload, bool compressionEnabled, CompressionProfile profile) {
+    FramedPacket frame;
+    frame.bytes.reserve(PacketWriter::HEADER_SPACE + payload.size());
+    frame.bytes.resize(PacketWriter::HEADER_SPACE);
+    frame.bytes.insert(frame.bytes.end(), payload.begin(), payload.end());
+    frame.start = frameInPlace(frame.bytes, compressionEnabled, profile);
+    return frame;
+}
 
-    // Handle encryption if enabled
+// Packet IDs below 0x80 are a single VarInt byte, anything else is not counted
+static int32_t leadingPacketID(std::span<const uint8_t> payload) {
+    return payload.empty() ? -1 : payload[0];
+}
+
+static void recordClientbound(const ClientConnection& client, int32_t packetID, const FramedPacket& frame, std::chrono::steady_clock::time_point start) {
+    recordPacket(PacketDirection::Clientbound, client.state, packetID, frame.size(), std::chrono::steady_clock::now() - start);
+}
+
+// Caller holds sendMutex. Packets are encrypted in queue order, the stream cipher requires it.
+static bool queueFrame(ClientConnection& client, FramedPacket frame) {
     if (serverConfig.enableEncryption && client.encryptCtx) {
-        // Encrypt dataToSend
-        std::vector<uint8_t> encryptedData(dataToSend.size() + EVP_CIPHER_block_size(EVP_aes_128_cfb8()));
+        // AES/CFB8 produces exactly one byte per input byte, so the frame is encrypted in place
+        uint8_t* data = frame.bytes.data() + frame.start;
         int outLen = 0;
-        if (EVP_EncryptUpdate(client.encryptCtx, encryptedData.data(), &outLen, dataToSend.data(), dataToSend.size()) != 1) {
+        if (EVP_EncryptUpdate(client.encryptCtx, data, &outLen, data, static_cast<int>(frame.size())) != 1) {
             logMessage("Failed to encrypt packet data", LOG_ERROR);
             ERR_print_errors_fp(stderr);
             return false;
         }
-        encryptedData.resize(outLen);
-        dataToSend = encryptedData;
     }
+    return queueOutbound(client, std::move(frame));
+}
 
-    // Send the packet
-    size_t totalSent = 0;
-    size_t packetSize = dataToSend.size();
-    const char* dataPtr = reinterpret_cast<const char*>(dataToSend.data());
+bool sendUnencryptedPacket(ClientConnection& client, const std::vector<uint8_t>& packetData) {
+    std::lock_guard lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    FramedPacket frame = framePacket(packetData, false, CompressionProfile::Default);
+    recordClientbound(client, leadingPacketID(packetData), frame, start);
+    return queueOutbound(client, std::move(frame));
+}
 
-    while (totalSent < packetSize) {
-        ssize_t sent = send(client.socket, dataPtr + totalSent, packetSize - totalSent, 0);
-        if (sent == -1) {
-            logMessage("Failed to send packet: " + std::string(strerror(errno)), LOG_ERROR);
-            return false;
-        }
-        totalSent += sent;
+bool sendUnencryptedPacket(ClientConnection& client, PacketWriter&& packet) {
+    std::lock_guard lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return false;
     }
-    return true;
+    int32_t packetID = leadingPacketID(packet.payload());
+    auto start = std::chrono::steady_clock::now();
+    FramedPacket frame{packet.release()};
+    frame.start = frameInPlace(frame.bytes, false, CompressionProfile::Default);
+    recordClientbound(client, packetID, frame, start);
+    return queueOutbound(client, std::move(frame));
 }
 
-void broadcastToOthers(const std::vector<uint8_t>& packetData, const std::string& excludeUUID) {
+bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData, CompressionProfile profile) {
+    std::lock_guard<std::mutex> lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    FramedPacket frame;
+    try {
+        frame = framePacket(packetData, client.compressionEnabled, profile);
+    } catch (const std::exception& e) {
+        logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
+        return false;
+    }
+    recordClientbound(client, leadingPacketID(packetData), frame, start);
+    return queueFrame(client, std::move(frame));
+}
+
+bool sendPacket(ClientConnection& client, PacketWriter&& packet, CompressionProfile profile) {
+    std::lock_guard<std::mutex> lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return false;
+    }
+
+    int32_t packetID = leadingPacketID(packet.payload());
+    auto start = std::chrono::steady_clock::now();
+    // The writer's buffer goes all the way to the socket
+    FramedPacket frame{packet.release()};
+    try {
+        frame.start = frameInPlace(frame.bytes, client.compressionEnabled, profile);
+    } catch (const std::exception& e) {
+        logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
+        return false;
+    }
+    recordClientbound(client, packetID, frame, start);
+    return queueFrame(client, std::move(frame));
+}
+
+const FramedPacket& EncodedPacket::frame(bool compressionEnabled) {
+    std::span<const uint8_t> payload = std::span(packetData).subspan(payloadStart);
+    if (compressionEnabled) {
+        std::call_once(compressedOnce, [&] { compressedFrame = framePacket(payload, true, profile); });
+        return compressedFrame;
+    }
+    std::call_once(plainOnce, [&] { plainFrame = framePacket(payload, false, profile); });
+    return plainFrame;
+}
+
+bool sendPacket(ClientConnection& client, EncodedPacket& packet) {
+    std::lock_guard<std::mutex> lock(client.sendMutex);
+    if (client.connectionClosed) {
+        return false;
+    }
+
+    std::span<const uint8_t> frame;
+    try {
+        frame = packet.frame(client.compressionEnabled).view();
+    } catch (const std::exception& e) {
+        logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
+        return false;
+    }
+    // Encoded once for all recipients, so only the traffic is counted
+    recordPacket(PacketDirection::Clientbound, client.state, packet.packetID(), frame.size());
+    // Only the copy that gets encrypted is made per recipient
+    return queueFrame(client, FramedPacket{std::vector(frame.begin(), frame.end())});
+}
+
+// Recipients are collected under the lock, the packets are queued without it
+static std::vector<std::shared_ptr<ClientConnection>> collectRecipients(const std::string& excludeUUID) {
+    std::vector<std::shared_ptr<ClientConnection>> recipients;
     std::lock_guard lock(connectedClientsMutex);
+    recipients.reserve(connectedClients.size());
     for (const auto& [uuid, client] : connectedClients) {
         if (uuid != excludeUUID) {
-            sendPacket(*client, packetData);
+            recipients.push_back(client);
         }
     }
+    return recipients;
+}
+
+void broadcastToOthers(const std::vector<uint8_t>& packetData, const std::string& excludeUUID) {
+    EncodedPacket packet(packetData);
+    for (const auto& client : collectRecipients(excludeUUID)) {
+        sendPacket(*client, packet);
+    }
+}
+
+void broadcastToOthers(PacketWriter&& packetData, const std::string& excludeUUID) {
+    EncodedPacket packet(std::move(packetData));
+    for (const auto& client : collectRecipients(excludeUUID)) {
+        sendPacket(*client, packet);
+    }
 }
\ No newline at end of file
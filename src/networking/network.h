@@ -3,8 +3,11 @@
 #include <vector>
 #include <cstdint>
 #include <mutex>
+#include <span>
 #include <string>
 
+#include "packet_writer.h"
+
 #ifdef _WIN32
 #include <winsock2.h>
 typedef SOCKET SocketType;
@@ -20,7 +23,30 @@ typedef int SocketType;
 struct SlotData;
 struct ClientConnection;
 
-int32_t readVarInt(SocketType sock);
+// Selects the zlib level a packet is compressed with
+enum class CompressionProfile {
+    Default,
+    Chunk,
+};
+
+// Wire-ready packet, the frame starts at offset start of bytes
+struct FramedPacket {
+    std::vector<uint8_t> bytes;
+    size_t start = 0;
+
+    [[nodiscard]] size_t size() const { return bytes.size() - start; }
+    [[nodiscard]] std::span<const uint8_t> view() const { return std::span(bytes).subspan(start); }
+};
+
+// Maximum packet length the protocol allows (3-byte VarInt)
+constexpr int32_t MAX_PACKET_LENGTH = 2097151;
+
+enum class FrameResult {
+    Packet,
+    Incomplete,
+    Error,
+};
+
 void writeVarInt(std::vector<uint8_t>& buffer, int32_t value);
 void writeString(std::vector<uint8_t>& buffer, const std::string& str);
 void writeInt(std::vector<uint8_t>& buffer, int32_t value);
@@ -34,22 +60,59 @@ void writeShort(std::vector<uint8_t>& buffer, int16_t value);
 void writeVarLong(std::vector<uint8_t>& buffer, uint64_t value);
 void writeSlotSimple(std::vector<uint8_t>& buffer, const SlotData& slot);
 void writeUUID(std::vector<uint8_t>& buffer, const std::array<uint8_t, 16>& uuid);
-int32_t parseVarInt(const std::vector<uint8_t>& data, size_t& index);
-int64_t parseLong(const std::vector<uint8_t>& data, size_t& index);
-short parseShort(const std::vector<uint8_t>& data, size_t& index);
-float parseFloat(const std::vector<uint8_t>& data, size_t& index);
-double parseDouble(const std::vector<uint8_t>& data, size_t& index);
-std::string parseString(const std::vector<uint8_t>& data, size_t& index);
-std::vector<uint8_t> parseBytes(const std::vector<uint8_t>& data, size_t& index, size_t length);
-uint8_t parseByte(const std::vector<uint8_t>& data, size_t& index);
-uint64_t parseVarLong(const std::vector<uint8_t>& data, size_t& index);
-SlotData parseSlotData(const std::vector<uint8_t>& data, size_t& index);
-bool readUnencryptedPacket(const ClientConnection& client, std::vector<uint8_t>& packetData);
-bool readPacketTimeout(const ClientConnection& client, std::vector<uint8_t>& packetData, int timeout, bool unencrypted);
-bool readPacket(const ClientConnection& client, std::vector<uint8_t>& packetData);
+int32_t parseVarInt(std::span<const uint8_t> data, size_t& index);
+int64_t parseLong(std::span<const uint8_t> data, size_t& index);
+short parseShort(std::span<const uint8_t> data, size_t& index);
+float parseFloat(std::span<const uint8_t> data, size_t& index);
+double parseDouble(std::span<const uint8_t> data, size_t& index);
+std::string parseString(std::span<const uint8_t> data, size_t& index);
+std::vector<uint8_t> parseBytes(std::span<const uint8_t> data, size_t& index, size_t length);
+uint8_t parseByte(std::span<const uint8_t> data, size_t& index);
+uint64_t parseVarLong(std::span<const uint8_t> data, size_t& index);
+SlotData parseSlotData(std::span<const uint8_t> data, size_t& index);
+bool commitInbound(ClientConnection& client, size_t length);
+bool decryptInbound(ClientConnection& client, size_t offset);
+// The packet view stays valid until the next read from the socket
+FrameResult nextBufferedPacket(ClientConnection& client, std::span<const uint8_t>& packet);
+void shutdownConnection(ClientConnection& client);
+// Packets are queued per connection and written out by flushPackets
+bool flushPackets(ClientConnection& client);
 bool sendUnencryptedPacket(ClientConnection& client, const std::vector<uint8_t>& packetData);
-bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData);
+bool sendUnencryptedPacket(ClientConnection& client, PacketWriter&& packet);
+bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData, CompressionProfile profile = CompressionProfile::Default);
+bool sendPacket(ClientConnection& client, PacketWriter&& packet, CompressionProfile profile = CompressionProfile::Default);
+// A PacketWriter is consumed by sending it, pass it with std::move
+bool sendUnencryptedPacket(ClientConnection& client, const PacketWriter& packet) = delete;
+bool sendPacket(ClientConnection& client, const PacketWriter& packet, CompressionProfile profile = CompressionProfile::Default) = delete;
+
+// A packet framed and compressed once, then shared by every recipient.
+// Only the per-connection encryption is done for each client.
+class EncodedPacket {
+public:
+    explicit EncodedPacket(std::vector<uint8_t> packetData, CompressionProfile profile = CompressionProfile::Default)
+        : packetData(std::move(packetData)), profile(profile) {}
+    explicit EncodedPacket(PacketWriter&& packet, CompressionProfile profile = CompressionProfile::Default)
+        : packetData(packet.release()), payloadStart(PacketWriter::HEADER_SPACE), profile(profile) {}
+    explicit EncodedPacket(const PacketWriter& packet, CompressionProfile profile = CompressionProfile::Default) = delete;
+
+    const FramedPacket& frame(bool compressionEnabled);
+    [[nodiscard]] int32_t packetID() const { return payloadStart < packetData.size() ? packetData[payloadStart] : -1; }
+    [[nodiscard]] size_t payloadSize() const { return packetData.size() - payloadStart; }
+
+private:
+    std::vector<uint8_t> packetData;
+    size_t payloadStart = 0;
+    CompressionProfile profile;
+    std::once_flag compressedOnce;
+    std::once_flag plainOnce;
+    FramedPacket compressedFrame;
+    FramedPacket plainFrame;
+};
+
+bool sendPacket(ClientConnection& client, EncodedPacket& packet);
 void broadcastToOthers(const std::vector<uint8_t>& packetData, const std::string& excludeUUID = "");
+void broadcastToOthers(PacketWriter&& packet, const std::string& excludeUUID = "");
+void broadcastToOthers(const PacketWriter& packet, const std::string& excludeUUID = "") = delete;
 
 #endif // NETWORK_H
 
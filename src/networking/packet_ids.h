@@ -59,6 +59,10 @@
 #define UPDATE_ATTRIBUTES 0x75
 #define SET_HELD_ITEM 0x53
 #define FEATURE_FLAGS 0x0C
+#define CHUNK_BATCH_FINISHED 0x0C
+#define CHUNK_BATCH_START 0x0D
+#define CHUNK_DATA 0x27
+#define UNLOAD_CHUNK 0x21
 
 // Client -> Server Packets
 #define STATUS_REQUEST 0x00
@@ -72,6 +76,7 @@
 #define CHAT_COMMAND 0x04
 #define CHAT_MESSAGE 0x06
 #define PLAYER_SESSION 0x07
+#define CHUNK_BATCH_RECEIVED 0x08
 #define SERVERBOUND_KNOWN_PACKS 0x07
 #define PLUGIN_MESSAGE_PLAY 0x12
 #define COMMAND_SUGGESTIONS_REQUEST 0x0B
@@ -0,0 +1,67 @@
+#include "packet_reader.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+int32_t PacketReader::readVarInt() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t currentByte = readByte();
+        value |= static_cast<uint32_t>(currentByte & 0x7F) << shift;
+        if ((currentByte & 0x80) == 0) {
+            return static_cast<int32_t>(value);
+        }
+    }
+    throw std::runtime_error("VarInt is too big");
+}
+
+int64_t PacketReader::readVarLong() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 70; shift += 7) {
+        uint8_t currentByte = readByte();
+        value |= static_cast<uint64_t>(currentByte & 0x7F) << shift;
+        if ((currentByte & 0x80) == 0) {
+            return static_cast<int64_t>(value);
+        }
+    }
+    throw std::runtime_error("VarLong is too big");
+}
+
+std::string_view PacketReader::readString(size_t maxLength) {
+    int32_t length = readVarInt();
+    if (length < 0 || static_cast<size_t>(length) > maxLength) {
+        throw std::out_of_range("String length " + std::to_string(length) + " exceeds " + std::to_string(maxLength));
+    }
+    std::span<const uint8_t> bytes = readBytes(length);
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+std::span<const uint8_t> PacketReader::readBytes(size_t length) {
+    require(length);
+    std::span<const uint8_t> bytes = data.subspan(index, length);
+    index += length;
+    return bytes;
+}
+
+std::span<const uint8_t> PacketReader::readRemaining() {
+    return readBytes(remaining());
+}
+
+std::array<uint8_t, 16> PacketReader::readUUID() {
+    std::array<uint8_t, 16> uuid{};
+    std::span<const uint8_t> bytes = readBytes(uuid.size());
+    std::copy(bytes.begin(), bytes.end(), uuid.begin());
+    return uuid;
+}
+
+void PacketReader::skip(size_t length) {
+    require(length);
+    index += length;
+}
+
+void PacketReader::require(size_t length) const {
+    if (length > remaining()) {
+        throw std::out_of_range("Packet too short: needed " + std::to_string(length) + " bytes at offset " + std::to_string(index) + " of " + std::to_string(data.size()));
+    }
+}
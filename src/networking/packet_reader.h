@@ -0,0 +1,59 @@
+#ifndef PACKET_READER_H
+#define PACKET_READER_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Bounds-checked reader over a serverbound packet.
+// Nothing is copied, strings and byte arrays are views into the packet and only valid while it is.
+// Reading past the end throws std::out_of_range, which drops the connection.
+class PacketReader {
+public:
+    explicit PacketReader(std::span<const uint8_t> data, size_t index = 0) : data(data), index(index) {}
+
+    [[nodiscard]] size_t position() const { return index; }
+    [[nodiscard]] size_t remaining() const { return index < data.size() ? data.size() - index : 0; }
+
+    uint8_t readByte() {
+        require(1);
+        return data[index++];
+    }
+    bool readBool() { return readByte() != 0; }
+    int16_t readShort() { return static_cast<int16_t>(readBigEndian<uint16_t>()); }
+    uint16_t readUShort() { return readBigEndian<uint16_t>(); }
+    int32_t readInt() { return static_cast<int32_t>(readBigEndian<uint32_t>()); }
+    int64_t readLong() { return static_cast<int64_t>(readBigEndian<uint64_t>()); }
+    float readFloat() { return std::bit_cast<float>(readBigEndian<uint32_t>()); }
+    double readDouble() { return std::bit_cast<double>(readBigEndian<uint64_t>()); }
+
+    int32_t readVarInt();
+    int64_t readVarLong();
+    // Length-prefixed UTF-8 string, maxLength is counted in bytes
+    std::string_view readString(size_t maxLength = 32767 * 3);
+    std::span<const uint8_t> readBytes(size_t length);
+    std::span<const uint8_t> readRemaining();
+    std::array<uint8_t, 16> readUUID();
+    void skip(size_t length);
+
+private:
+    void require(size_t length) const;
+
+    template<typename T>
+    T readBigEndian() {
+        require(sizeof(T));
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value = static_cast<T>(value << 8 | data[index + i]);
+        }
+        index += sizeof(T);
+        return value;
+    }
+
+    std::span<const uint8_t> data;
+    size_t index;
+};
+
+#endif // PACKET_READER_H
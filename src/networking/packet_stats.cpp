@@ -0,0 +1,334 @@
+#include "packet_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "client.h"
+#include "packet_ids.h"
+
+// Handshake, Status, Login, Configuration and Play; AwaitingTeleportConfirm counts as Play
+constexpr size_t STATE_COUNT = 5;
+
+using PacketStatsTable = std::array<std::array<std::array<PacketStats, PACKET_ID_LIMIT>, STATE_COUNT>, 2>;
+using PacketNameTable = std::array<std::array<std::array<const char*, PACKET_ID_LIMIT>, STATE_COUNT>, 2>;
+
+static PacketStatsTable packetStats;
+
+static size_t stateIndex(ClientState state) {
+    switch (state) {
+        case ClientState::Handshake:
+            return 0;
+        case ClientState::Status:
+            return 1;
+        case ClientState::Login:
+            return 2;
+        case ClientState::Configuration:
+            return 3;
+        case ClientState::Play:
+        case ClientState::AwaitingTeleportConfirm:
+            break;
+    }
+    return 4;
+}
+
+static const char* stateName(size_t index) {
+    static constexpr std::array<const char*, STATE_COUNT> names = {"HANDSHAKE", "STATUS", "LOGIN", "CONFIGURATION", "PLAY"};
+    return names[index];
+}
+
+// Names of the packets this server knows, taken from packet_ids.h
+static const PacketNameTable& packetNames() {
+    static const PacketNameTable names = [] {
+        PacketNameTable table{};
+#define PACKET_NAME(direction, state, id) table[static_cast<size_t>(PacketDirection::direction)][state][id] = #id
+        PACKET_NAME(Serverbound, 0, HANDSHAKE);
+        PACKET_NAME(Serverbound, 1, STATUS_REQUEST);
+        PACKET_NAME(Serverbound, 1, PING_REQUEST);
+        table[0][2][0x00] = "LOGIN_START";
+        table[0][2][0x01] = "ENCRYPTION_RESPONSE";
+        PACKET_NAME(Serverbound, 2, LOGIN_PLUGIN_RESPONSE);
+        PACKET_NAME(Serverbound, 2, LOGIN_ACKNOWLEDGE);
+        PACKET_NAME(Serverbound, 3, CLIENT_INFORMATION);
+        table[0][3][0x02] = "PLUGIN_MESSAGE_CONFIG";
+        PACKET_NAME(Serverbound, 3, ACKNOWLEDGE_FINISH_CONFIGURATION);
+        PACKET_NAME(Serverbound, 3, SERVERBOUND_KNOWN_PACKS);
+        PACKET_NAME(Serverbound, 4, ZERO_PACKET);
+        PACKET_NAME(Serverbound, 4, CHAT_COMMAND);
+        PACKET_NAME(Serverbound, 4, CHAT_MESSAGE);
+        PACKET_NAME(Serverbound, 4, PLAYER_SESSION);
+        PACKET_NAME(Serverbound, 4, CHUNK_BATCH_RECEIVED);
+        PACKET_NAME(Serverbound, 4, COMMAND_SUGGESTIONS_REQUEST);
+        PACKET_NAME(Serverbound, 4, CLICK_CONTAINER);
+        PACKET_NAME(Serverbound, 4, CLOSE_CONTAINER);
+        PACKET_NAME(Serverbound, 4, PLUGIN_MESSAGE_PLAY);
+        PACKET_NAME(Serverbound, 4, SERVERBOUND_KEEP_ALIVE);
+        PACKET_NAME(Serverbound, 4, PLAYER_POSITION);
+        PACKET_NAME(Serverbound, 4, PLAYER_POSITION_AND_ROTATION);
+        PACKET_NAME(Serverbound, 4, Player_ROTATION);
+        PACKET_NAME(Serverbound, 4, PLAYER_ON_GROUND);
+        PACKET_NAME(Serverbound, 4, PLAYER_ACTION);
+        PACKET_NAME(Serverbound, 4, PLAYER_COMMAND);
+        PACKET_NAME(Serverbound, 4, RESOURCE_PACK_RESPONSE_PLAY);
+        PACKET_NAME(Serverbound, 4, HELD_ITEM);
+        PACKET_NAME(Serverbound, 4, CREATIVE_MODE_SLOT);
+        PACKET_NAME(Serverbound, 4, SWING_ARM);
+        PACKET_NAME(Serverbound, 4, USE_ITEM_ON);
+
+        PACKET_NAME(Clientbound, 1, STATUS_RESPONSE);
+        PACKET_NAME(Clientbound, 1, PONG_RESPONSE);
+        PACKET_NAME(Clientbound, 2, DISCONNECT);
+        table[1][2][0x01] = "ENCRYPTION_REQUEST";
+        PACKET_NAME(Clientbound, 2, LOGIN_SUCCESS);
+        PACKET_NAME(Clientbound, 2, SET_COMPRESSION);
+        PACKET_NAME(Clientbound, 3, CLIENTBOUND_PLUGIN_MESSAGE_CONFIG);
+        PACKET_NAME(Clientbound, 3, FINISH_CONFIGURATION);
+        PACKET_NAME(Clientbound, 3, REGISTRY_DATA);
+        PACKET_NAME(Clientbound, 3, REMOVE_RESOURCE_PACK_CONFIG);
+        PACKET_NAME(Clientbound, 3, FEATURE_FLAGS);
+        PACKET_NAME(Clientbound, 3, UPDATE_TAGS);
+        PACKET_NAME(Clientbound, 3, CLIENTBOUND_KNOWN_PACKS);
+        PACKET_NAME(Clientbound, 3, SERVER_LINKS);
+        PACKET_NAME(Clientbound, 4, BUNDLE_DELIMITER);
+        PACKET_NAME(Clientbound, 4, SPAWN_ENTITY);
+        PACKET_NAME(Clientbound, 4, ENTITY_ANIMATION);
+        PACKET_NAME(Clientbound, 4, ACKNOWLEDGE_BLOCK_CHANGE);
+        PACKET_NAME(Clientbound, 4, BLOCK_DESTROY_STAGE);
+        PACKET_NAME(Clientbound, 4, BOSS_BAR);
+        PACKET_NAME(Clientbound, 4, COMMAND_SUGGESTIONS_RESPONSE);
+        PACKET_NAME(Clientbound, 4, COMMANDS);
+        PACKET_NAME(Clientbound, 4, CHUNK_BATCH_FINISHED);
+        PACKET_NAME(Clientbound, 4, CHUNK_BATCH_START);
+        PACKET_NAME(Clientbound, 4, CHUNK_DATA);
+        PACKET_NAME(Clientbound, 4, UNLOAD_CHUNK);
+        PACKET_NAME(Clientbound, 4, SET_CONTAINER_CONTENT);
+        PACKET_NAME(Clientbound, 4, SET_CONTAINER_SLOT);
+        PACKET_NAME(Clientbound, 4, ENTITY_EVENT);
+        PACKET_NAME(Clientbound, 4, GAME_EVENT);
+        PACKET_NAME(Clientbound, 4, INITIALIZE_WORLD_BORDER);
+        PACKET_NAME(Clientbound, 4, KEEP_ALIVE_PLAY);
+        PACKET_NAME(Clientbound, 4, WORLD_EVENT);
+        PACKET_NAME(Clientbound, 4, LOGIN);
+        PACKET_NAME(Clientbound, 4, UPDATE_ENTITY_POSITION);
+        PACKET_NAME(Clientbound, 4, UPDATE_ENTITY_POSITION_AND_ROTATION);
+        PACKET_NAME(Clientbound, 4, UPDATE_ENTITY_ROTATION);
+        PACKET_NAME(Clientbound, 4, OPEN_SCREEN);
+        PACKET_NAME(Clientbound, 4, PLAYER_ABILITIES);
+        PACKET_NAME(Clientbound, 4, PLAYER_CHAT_MESSAGE);
+        PACKET_NAME(Clientbound, 4, PLAYER_INFO_REMOVE);
+        PACKET_NAME(Clientbound, 4, PLAYER_INFO_UPDATE);
+        PACKET_NAME(Clientbound, 4, SYNCHRONIZE_PLAYER_POSITION);
+        PACKET_NAME(Clientbound, 4, REMOVE_ENTITIES);
+        PACKET_NAME(Clientbound, 4, ADD_RESOURCE_PACK_PLAY);
+        PACKET_NAME(Clientbound, 4, SET_HEAD_ROTATION);
+        PACKET_NAME(Clientbound, 4, SET_BORDER_CENTER);
+        PACKET_NAME(Clientbound, 4, SET_BORDER_LERP_SIZE);
+        PACKET_NAME(Clientbound, 4, SET_BORDER_SIZE);
+        PACKET_NAME(Clientbound, 4, SET_BORDER_WARNING_DELAY);
+        PACKET_NAME(Clientbound, 4, SET_BORDER_WARNING_DISTANCE);
+        PACKET_NAME(Clientbound, 4, SET_HELD_ITEM);
+        PACKET_NAME(Clientbound, 4, SET_CENTER_CHUNK);
+        PACKET_NAME(Clientbound, 4, SET_ENTITY_METADATA);
+        PACKET_NAME(Clientbound, 4, SET_ENTITY_VELOCITY);
+        PACKET_NAME(Clientbound, 4, SET_EQUIPMENT);
+        PACKET_NAME(Clientbound, 4, UPDATE_TIME);
+        PACKET_NAME(Clientbound, 4, SYSTEM_CHAT_MESSAGE);
+        PACKET_NAME(Clientbound, 4, PICK_UP_ITEM);
+        PACKET_NAME(Clientbound, 4, TELEPORT_ENTITY);
+        PACKET_NAME(Clientbound, 4, UPDATE_ATTRIBUTES);
+        PACKET_NAME(Clientbound, 4, UPDATE_RECIPES);
+#undef PACKET_NAME
+        return table;
+    }();
+    return names;
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t nanos) {
+    nanos = std::min<uint64_t>(nanos, (uint64_t{1} << MAX_VALUE_BITS) - 1);
+    if (nanos < SUB_BUCKETS) {
+        return nanos;
+    }
+    // Each power of two gets SUB_BUCKETS linear buckets
+    int exponent = std::bit_width(nanos) - SUB_BUCKET_BITS;
+    return exponent * SUB_BUCKETS + ((nanos >> (exponent - 1)) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketValue(size_t index) {
+    size_t exponent = index / SUB_BUCKETS;
+    uint64_t subBucket = index % SUB_BUCKETS;
+    if (exponent == 0) {
+        return subBucket;
+    }
+    // Highest value that falls into the bucket
+    return ((subBucket + SUB_BUCKETS + 1) << (exponent - 1)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumNanos.fetch_add(nanos, std::memory_order_relaxed);
+    uint64_t currentMax = maxNanos.load(std::memory_order_relaxed);
+    while (nanos > currentMax && !maxNanos.compare_exchange_weak(currentMax, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sumNanos.store(0, std::memory_order_relaxed);
+    maxNanos.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t recorded = count();
+    if (recorded == 0) {
+        return 0;
+    }
+
+    auto target = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(recorded)));
+    target = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(bucketValue(i), max());
+        }
+    }
+    return max();
+}
+
+PacketStats* getPacketStats(PacketDirection direction, ClientState state, int32_t packetID) {
+    if (packetID < 0 || packetID >= PACKET_ID_LIMIT) {
+        return nullptr;
+    }
+    return &packetStats[static_cast<size_t>(direction)][stateIndex(state)][packetID];
+}
+
+void recordPacket(PacketDirection direction, ClientState state, int32_t packetID, size_t bytes) {
+    PacketStats* stats = getPacketStats(direction, state, packetID);
+    if (!stats) {
+        return;
+    }
+    stats->count.fetch_add(1, std::memory_order_relaxed);
+    stats->bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void recordPacket(PacketDirection direction, ClientState state, int32_t packetID, size_t bytes, std::chrono::steady_clock::duration elapsed) {
+    PacketStats* stats = getPacketStats(direction, state, packetID);
+    if (!stats) {
+        return;
+    }
+    stats->count.fetch_add(1, std::memory_order_relaxed);
+    stats->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    stats->time.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+static std::string packetName(size_t direction, size_t state, size_t packetID) {
+    if (const char* name = packetNames()[direction][state][packetID]) {
+        return name;
+    }
+    char hex[8];
+    std::snprintf(hex, sizeof(hex), "0x%02zX", packetID);
+    return hex;
+}
+
+const char* getPacketName(PacketDirection direction, ClientState state, int32_t packetID) {
+    if (packetID < 0 || packetID >= PACKET_ID_LIMIT) {
+        return nullptr;
+    }
+    return packetNames()[static_cast<size_t>(direction)][stateIndex(state)][packetID];
+}
+
+static std::string formatNanos(uint64_t nanos) {
+    char buffer[32];
+    if (nanos < 1000) {
+        std::snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(nanos));
+    } else if (nanos < 1000000) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fus", static_cast<double>(nanos) / 1e3);
+    } else if (nanos < 1000000000) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fms", static_cast<double>(nanos) / 1e6);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2fs", static_cast<double>(nanos) / 1e9);
+    }
+    return buffer;
+}
+
+static std::string formatBytes(uint64_t bytes) {
+    char buffer[32];
+    if (bytes < 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%lluB", static_cast<unsigned long long>(bytes));
+    } else if (bytes < 1024 * 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fKiB", static_cast<double>(bytes) / 1024);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.1fMiB", static_cast<double>(bytes) / (1024 * 1024));
+    }
+    return buffer;
+}
+
+std::string formatPacketStats(size_t limit) {
+    std::string output;
+    for (size_t direction = 0; direction < 2; ++direction) {
+        struct Row {
+            size_t state;
+            size_t packetID;
+            const PacketStats* stats;
+        };
+        std::vector<Row> rows;
+        uint64_t directionNanos = 0;
+        for (size_t state = 0; state < STATE_COUNT; ++state) {
+            for (size_t packetID = 0; packetID < PACKET_ID_LIMIT; ++packetID) {
+                const PacketStats& stats = packetStats[direction][state][packetID];
+                if (stats.count.load(std::memory_order_relaxed) > 0) {
+                    rows.push_back({state, packetID, &stats});
+                    directionNanos += stats.time.sum();
+                }
+            }
+        }
+        std::ranges::sort(rows, [](const Row& a, const Row& b) {
+            if (a.stats->time.sum() != b.stats->time.sum()) {
+                return a.stats->time.sum() > b.stats->time.sum();
+            }
+            return a.stats->bytes.load(std::memory_order_relaxed) > b.stats->bytes.load(std::memory_order_relaxed);
+        });
+
+        output += direction == static_cast<size_t>(PacketDirection::Serverbound)
+            ? "Serverbound packets (handler time):\n"
+            : "Clientbound packets (encode time):\n";
+        if (rows.empty()) {
+            output += "  none\n";
+        }
+        for (size_t i = 0; i < rows.size() && i < limit; ++i) {
+            const Row& row = rows[i];
+            const LatencyHistogram& time = row.stats->time;
+            double share = directionNanos > 0 ? 100.0 * static_cast<double>(time.sum()) / static_cast<double>(directionNanos) : 0.0;
+            char shareText[16];
+            std::snprintf(shareText, sizeof(shareText), "%.1f%%", share);
+
+            output += "  " + std::string(stateName(row.state)) + " " + packetName(direction, row.state, row.packetID)
+                + ": " + std::to_string(row.stats->count.load(std::memory_order_relaxed)) + " packets, "
+                + formatBytes(row.stats->bytes.load(std::memory_order_relaxed)) + ", " + shareText + " of time";
+            if (time.count() > 0) {
+                output += ", p50 " + formatNanos(time.percentile(0.5)) + ", p99 " + formatNanos(time.percentile(0.99))
+                    + ", max " + formatNanos(time.max());
+            }
+            output += "\n";
+        }
+    }
+    return output;
+}
+
+void resetPacketStats() {
+    for (auto& direction : packetStats) {
+        for (auto& state : direction) {
+            for (auto& stats : state) {
+                stats.count.store(0, std::memory_order_relaxed);
+                stats.bytes.store(0, std::memory_order_relaxed);
+                stats.time.reset();
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef PACKET_STATS_H
+#define PACKET_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+enum class ClientState;
+
+enum class PacketDirection {
+    Serverbound,
+    Clientbound,
+};
+
+// Packet IDs of every state fit in one VarInt byte
+constexpr int32_t PACKET_ID_LIMIT = 0x80;
+
+// HDR-style latency histogram: power-of-two ranges split into linear sub-buckets,
+// so every recorded value is kept with a relative error of at most 1/8.
+// Recording is a few relaxed atomic increments.
+class LatencyHistogram {
+public:
+    void record(uint64_t nanos);
+    void reset();
+
+    [[nodiscard]] uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t sum() const { return sumNanos.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t max() const { return maxNanos.load(std::memory_order_relaxed); }
+    // Value below which the given fraction (0..1) of the recorded values fall
+    [[nodiscard]] uint64_t percentile(double fraction) const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Values are clamped to about 17 seconds
+    static constexpr int MAX_VALUE_BITS = 34;
+    static constexpr int BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static size_t bucketIndex(uint64_t nanos);
+    static uint64_t bucketValue(size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sumNanos{0};
+    std::atomic<uint64_t> maxNanos{0};
+};
+
+struct PacketStats {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+    // Handler time for serverbound packets, framing and compression time for clientbound ones
+    LatencyHistogram time;
+};
+
+// Counters for a state and packet ID, nullptr if the ID is out of range
+PacketStats* getPacketStats(PacketDirection direction, ClientState state, int32_t packetID);
+void recordPacket(PacketDirection direction, ClientState state, int32_t packetID, size_t bytes, std::chrono::steady_clock::duration elapsed);
+// Without timing, e.g. a shared broadcast frame that was encoded once
+void recordPacket(PacketDirection direction, ClientState state, int32_t packetID, size_t bytes);
+
+const char* getPacketName(PacketDirection direction, ClientState state, int32_t packetID);
+
+// Most expensive packet types first, at most limit lines per direction
+std::string formatPacketStats(size_t limit);
+void resetPacketStats();
+
+#endif // PACKET_STATS_H
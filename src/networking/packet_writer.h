@@ -0,0 +1,39 @@
+#ifndef PACKET_WRITER_H
+#define PACKET_WRITER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Builds a clientbound packet in a single buffer.
+// Room for the Packet Length and Data Length VarInts is kept in front of the payload;
+// both are filled in place when the packet is sent, and encryption runs on the same buffer.
+class PacketWriter {
+public:
+    // Two VarInts of at most five bytes each
+    static constexpr size_t HEADER_SPACE = 10;
+
+    explicit PacketWriter(size_t expectedSize = 64) {
+        buffer.reserve(HEADER_SPACE + expectedSize);
+        buffer.resize(HEADER_SPACE);
+    }
+
+    // Lets the write* helpers append fields directly
+    operator std::vector<uint8_t>&() { return buffer; }
+
+    void push_back(uint8_t value) { buffer.push_back(value); }
+    template<typename InputIt>
+    void insert(std::vector<uint8_t>::const_iterator position, InputIt first, InputIt last) { buffer.insert(position, first, last); }
+    std::vector<uint8_t>::iterator end() { return buffer.end(); }
+
+    [[nodiscard]] size_t size() const { return buffer.size() - HEADER_SPACE; }
+    [[nodiscard]] std::span<const uint8_t> payload() const { return std::span(buffer).subspan(HEADER_SPACE); }
+
+    // Hands the buffer over, the payload starts at HEADER_SPACE
+    std::vector<uint8_t> release() { return std::move(buffer); }
+
+private:
+    std::vector<uint8_t> buffer;
+};
+
+#endif // PACKET_WRITER_H
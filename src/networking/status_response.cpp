@@ -0,0 +1,97 @@
+#include "status_response.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <ranges>
+#include <nlohmann/json.hpp>
+
+#include "client.h"
+#include "packet_ids.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+#include "entities/player.h"
+#include "utils/rate_limiter.h"
+
+// Vanilla shows at most 12 players when hovering the player count
+constexpr size_t MAX_PLAYER_SAMPLE = 12;
+// Requests allowed at once before the per-second rate applies
+constexpr double STATUS_BURST_SECONDS = 5.0;
+
+static std::mutex statusMutex;
+static std::shared_ptr<EncodedPacket> cachedResponse;
+static std::atomic<bool> responseDirty{true};
+
+// Inputs the cached response was built from
+static std::string cachedMotd;
+static int cachedMaxPlayers = 0;
+static int cachedOnline = -1;
+
+static std::string cachedIconPath;
+static std::string cachedFavicon;
+
+static RateLimiter statusLimiter(0, 1);
+static std::once_flag limiterConfigured;
+
+static std::shared_ptr<EncodedPacket> buildStatusResponse(int online) {
+    nlohmann::json sample = nlohmann::json::array();
+    if (serverConfig.statusPlayerSample) {
+        std::lock_guard lock(playersMutex);
+        for (const auto& player : globalPlayers | std::views::values) {
+            if (sample.size() >= MAX_PLAYER_SAMPLE) {
+                break;
+            }
+            sample.push_back({{"name", player->name}, {"id", player->uuidString}});
+        }
+    }
+
+    nlohmann::json responseJson = {
+        {"version", {{"name", serverConfig.server_version}, {"protocol", serverConfig.protocol_version}}},
+        {"players", {{"max", serverConfig.maxPlayers}, {"online", online}, {"sample", sample}}},
+        {"description", {{"text", serverConfig.motd}}}
+    };
+
+    // The icon is only read from disk when its path changes
+    if (cachedIconPath != serverConfig.icon) {
+        cachedIconPath = serverConfig.icon;
+        std::vector<uint8_t> faviconData = readFile(serverConfig.icon);
+        cachedFavicon = faviconData.empty() ? "" : "data:image/png;base64," + base64Encode(faviconData);
+    }
+    if (!cachedFavicon.empty()) {
+        responseJson["favicon"] = cachedFavicon;
+    }
+
+    std::string jsonResponse = responseJson.dump();
+
+    PacketWriter responseData(jsonResponse.size() + 8);
+    responseData.push_back(STATUS_RESPONSE);
+    writeVarInt(responseData, static_cast<int32_t>(jsonResponse.size()));
+    responseData.insert(responseData.end(), jsonResponse.begin(), jsonResponse.end());
+    return std::make_shared<EncodedPacket>(std::move(responseData));
+}
+
+std::shared_ptr<EncodedPacket> getStatusResponse() {
+    int online = playerCount.load();
+    std::lock_guard lock(statusMutex);
+    if (responseDirty.exchange(false) || !cachedResponse || online != cachedOnline ||
+        serverConfig.maxPlayers != cachedMaxPlayers || serverConfig.motd != cachedMotd) {
+        cachedOnline = online;
+        cachedMaxPlayers = serverConfig.maxPlayers;
+        cachedMotd = serverConfig.motd;
+        cachedResponse = buildStatusResponse(online);
+    }
+    return cachedResponse;
+}
+
+void invalidateStatusResponse() {
+    responseDirty = true;
+}
+
+bool allowStatusRequest(const std::string& address) {
+    std::call_once(limiterConfigured, [] {
+        double rate = serverConfig.statusRequestsPerSecond;
+        statusLimiter.configure(rate, rate * STATUS_BURST_SECONDS);
+    });
+    return statusLimiter.allow(address);
+}
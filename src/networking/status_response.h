@@ -0,0 +1,18 @@
+#ifndef STATUS_RESPONSE_H
+#define STATUS_RESPONSE_H
+
+#include <memory>
+#include <string>
+
+#include "network.h"
+
+// Server list ping response, serialized once and shared by every status request.
+// It is rebuilt when the MOTD, max players or online count changes.
+std::shared_ptr<EncodedPacket> getStatusResponse();
+// The player sample changed, rebuild on the next request
+void invalidateStatusResponse();
+
+// Per-IP limit for status requests
+bool allowStatusRequest(const std::string& address);
+
+#endif // STATUS_RESPONSE_H
@@ -1,5 +1,46 @@
 #include "registry_manager.h"
 
+#include "core/config.h"
+#include "core/utils.h"
+#include "networking/clientbound_packets.h"
+#include "networking/network.h"
+
+RegistryManager& RegistryManager::getInstance() {
+    static RegistryManager instance;
+    return instance;
+}
+
+RegistryManager::RegistryManager() : rsaKeyPair(serverConfig.rsaKeyFile) {
+}
+
+RegistryManager::~RegistryManager() = default;
+
+bool RegistryManager::buildConfigurationPackets() {
+    std::vector<PacketWriter> packets;
+    if (!buildRegistryDataPackets(packets, *this)) {
+        return false;
+    }
+    PacketWriter tags;
+    if (!buildUpdateTagsPacket(tags)) {
+        return false;
+    }
+
+    registryDataPackets.clear();
+    for (auto& packet : packets) {
+        registryDataPackets.push_back(std::make_unique<EncodedPacket>(std::move(packet)));
+    }
+    tagsPacket = std::make_unique<EncodedPacket>(std::move(tags));
+
+    // Compress now so the first logins don't pay for it
+    for (const auto& packet : registryDataPackets) {
+        packet->frame(serverConfig.enableCompression);
+    }
+    tagsPacket->frame(serverConfig.enableCompression);
+
+    logMessage("Built " + std::to_string(registryDataPackets.size() + 1) + " configuration packets.", LOG_DEBUG);
+    return true;
+}
+
 int32_t RegistryManager::addRegistryEntry(const std::string& registryName, const std::string& entryIdentifier) {
     auto& registry = registries[registryName];
     if (registry.contains(entryIdentifier)) {
@@ -1,15 +1,25 @@
 #ifndef REGISTRY_MANAGER_H
 #define REGISTRY_MANAGER_H
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "encryption/rsa_key.h"
 
+class EncodedPacket;
+
 
 // Registry Manager to handle registry entries and their IDs (and some other stuff like RSA keys, because why not)
+// Shared by every connection; the configuration phase packets are built once at startup and never change afterwards
 class RegistryManager {
 public:
+    static RegistryManager& getInstance();
+
+    RegistryManager(const RegistryManager&) = delete;
+    RegistryManager& operator=(const RegistryManager&) = delete;
+
     // Maps registry name to a map of entry identifier to ID
     std::unordered_map<std::string, std::unordered_map<std::string, int32_t>> registries;
 
@@ -21,8 +31,19 @@ public:
 
     RSAKeyPair& getRSAKeyPair() { return rsaKeyPair; }
 
+    // Serializes the registry data and tags packets, must run after the block tags are loaded
+    bool buildConfigurationPackets();
+
+    const std::vector<std::unique_ptr<EncodedPacket>>& getRegistryDataPackets() const { return registryDataPackets; }
+    EncodedPacket* getTagsPacket() const { return tagsPacket.get(); }
+
 private:
+    RegistryManager();
+    ~RegistryManager();
+
     RSAKeyPair rsaKeyPair;
+    std::vector<std::unique_ptr<EncodedPacket>> registryDataPackets;
+    std::unique_ptr<EncodedPacket> tagsPacket;
 };
 
 
@@ -0,0 +1,64 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// Thread-safe least recently used cache. Entries also expire after a fixed time to live.
+template<typename Key, typename Value>
+class LruCache {
+public:
+    LruCache(size_t capacity, std::chrono::steady_clock::duration ttl) : capacity(capacity), ttl(ttl) {}
+
+    std::optional<Value> get(const Key& key) {
+        std::lock_guard lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return std::nullopt;
+        }
+        if (std::chrono::steady_clock::now() >= it->second->expiresAt) {
+            entries.erase(it->second);
+            index.erase(it);
+            return std::nullopt;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->value;
+    }
+
+    void put(const Key& key, Value value) {
+        std::lock_guard lock(mutex);
+        auto expiresAt = std::chrono::steady_clock::now() + ttl;
+        if (auto it = index.find(key); it != index.end()) {
+            it->second->value = std::move(value);
+            it->second->expiresAt = expiresAt;
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+
+        entries.push_front({key, std::move(value), expiresAt});
+        index.emplace(key, entries.begin());
+        if (entries.size() > capacity) {
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    std::mutex mutex;
+    // Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<Key, typename std::list<Entry>::iterator> index;
+    size_t capacity;
+    std::chrono::steady_clock::duration ttl;
+};
+
+#endif // LRU_CACHE_H
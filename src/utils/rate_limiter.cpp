@@ -0,0 +1,50 @@
+#include "rate_limiter.h"
+
+#include <algorithm>
+
+// How often buckets that refilled completely are dropped
+constexpr auto PRUNE_INTERVAL = std::chrono::seconds(60);
+
+RateLimiter::RateLimiter(double ratePerSecond, double burst) : rate(ratePerSecond), burst(burst), lastPrune(std::chrono::steady_clock::now()) {
+}
+
+void RateLimiter::configure(double ratePerSecond, double burst) {
+    std::lock_guard lock(mutex);
+    this->rate = ratePerSecond;
+    this->burst = std::max(1.0, burst);
+    buckets.clear();
+}
+
+bool RateLimiter::allow(const std::string& key) {
+    std::lock_guard lock(mutex);
+    if (rate <= 0) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastPrune > PRUNE_INTERVAL) {
+        prune(now);
+    }
+
+    auto [it, inserted] = buckets.try_emplace(key, Bucket{burst, now});
+    Bucket& bucket = it->second;
+    if (!inserted) {
+        std::chrono::duration<double> elapsed = now - bucket.lastRefill;
+        bucket.tokens = std::min(burst, bucket.tokens + elapsed.count() * rate);
+        bucket.lastRefill = now;
+    }
+
+    if (bucket.tokens < 1.0) {
+        return false;
+    }
+    bucket.tokens -= 1.0;
+    return true;
+}
+
+void RateLimiter::prune(std::chrono::steady_clock::time_point now) {
+    std::erase_if(buckets, [&](const auto& entry) {
+        std::chrono::duration<double> elapsed = now - entry.second.lastRefill;
+        return entry.second.tokens + elapsed.count() * rate >= burst;
+    });
+    lastPrune = now;
+}
@@ -0,0 +1,33 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Token bucket per key, e.g. per IP address.
+// A rate of 0 disables the limit.
+class RateLimiter {
+public:
+    RateLimiter(double ratePerSecond, double burst);
+
+    void configure(double ratePerSecond, double burst);
+    bool allow(const std::string& key);
+
+private:
+    struct Bucket {
+        double tokens;
+        std::chrono::steady_clock::time_point lastRefill;
+    };
+
+    void prune(std::chrono::steady_clock::time_point now);
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Bucket> buckets;
+    double rate;
+    double burst;
+    std::chrono::steady_clock::time_point lastPrune;
+};
+
+#endif // RATE_LIMITER_H
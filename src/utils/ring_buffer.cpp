@@ -0,0 +1,58 @@
+#include "ring_buffer.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+RingBuffer::RingBuffer(size_t initialCapacity) : storage(std::bit_ceil(std::max<size_t>(initialCapacity, 64))), mask(storage.size() - 1) {
+}
+
+std::span<uint8_t> RingBuffer::prepareWrite(size_t minimum) {
+    if (capacity() - size() < minimum) {
+        grow(size() + minimum);
+    }
+
+    size_t start = tail & mask;
+    size_t contiguous = std::min(capacity() - size(), capacity() - start);
+    return {storage.data() + start, contiguous};
+}
+
+void RingBuffer::commitWrite(size_t length) {
+    tail += length;
+}
+
+std::pair<std::span<uint8_t>, std::span<uint8_t>> RingBuffer::readableSegments(size_t offset) {
+    if (offset >= size()) {
+        return {};
+    }
+
+    size_t start = (head + offset) & mask;
+    size_t length = size() - offset;
+    size_t first = std::min(length, capacity() - start);
+    return {{storage.data() + start, first}, {storage.data(), length - first}};
+}
+
+void RingBuffer::copyOut(size_t offset, size_t length, uint8_t* destination) const {
+    size_t start = (head + offset) & mask;
+    size_t first = std::min(length, capacity() - start);
+    std::memcpy(destination, storage.data() + start, first);
+    std::memcpy(destination + first, storage.data(), length - first);
+}
+
+void RingBuffer::consume(size_t length) {
+    head += std::min(length, size());
+    // Restart at the beginning of the storage so writes stay contiguous
+    if (head == tail) {
+        head = tail = 0;
+    }
+}
+
+void RingBuffer::grow(size_t minimum) {
+    std::vector<uint8_t> newStorage(std::bit_ceil(minimum));
+    size_t used = size();
+    copyOut(0, used, newStorage.data());
+    storage = std::move(newStorage);
+    mask = storage.size() - 1;
+    head = 0;
+    tail = used;
+}
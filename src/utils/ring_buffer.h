@@ -0,0 +1,40 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Growable byte ring with power-of-two capacity.
+// Data is written straight into the free space (e.g. by recv) and read back without compaction.
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t initialCapacity = 16384);
+
+    [[nodiscard]] size_t size() const { return tail - head; }
+    [[nodiscard]] bool empty() const { return head == tail; }
+    [[nodiscard]] size_t capacity() const { return storage.size(); }
+
+    // Contiguous free space at the tail, at least minimum bytes unless the free space wraps around
+    std::span<uint8_t> prepareWrite(size_t minimum);
+    void commitWrite(size_t length);
+
+    // Readable bytes starting at offset, split in at most two contiguous parts
+    std::pair<std::span<uint8_t>, std::span<uint8_t>> readableSegments(size_t offset);
+
+    [[nodiscard]] uint8_t peek(size_t offset) const { return storage[(head + offset) & mask]; }
+    void copyOut(size_t offset, size_t length, uint8_t* destination) const;
+    void consume(size_t length);
+
+private:
+    void grow(size_t minimum);
+
+    std::vector<uint8_t> storage;
+    size_t mask;
+    // Monotonic positions, wrapped with mask on access
+    size_t head = 0;
+    size_t tail = 0;
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,43 @@
+#include "task_strand.h"
+
+#include "core/utils.h"
+#include "thread_pool.h"
+
+bool TaskStrand::post(thread_pool& pool, std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        if (tasks.size() >= maxPending) {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+        if (scheduled) {
+            // The worker draining the strand picks it up
+            return true;
+        }
+        scheduled = true;
+    }
+
+    pool.enqueue([self = shared_from_this()] { self->drain(); });
+    return true;
+}
+
+void TaskStrand::drain() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::lock_guard lock(mutex);
+            if (tasks.empty()) {
+                scheduled = false;
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            logMessage("Strand task failed: " + std::string(e.what()), LOG_ERROR);
+        }
+    }
+}
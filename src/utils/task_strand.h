@@ -0,0 +1,29 @@
+#ifndef TASK_STRAND_H
+#define TASK_STRAND_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+class thread_pool;
+
+// Runs tasks on a shared thread pool one at a time, in the order they were posted.
+// At most one pool worker is busy with a strand at any time.
+class TaskStrand : public std::enable_shared_from_this<TaskStrand> {
+public:
+    explicit TaskStrand(size_t maxPending) : maxPending(maxPending) {}
+
+    // Returns false without queueing the task if too many tasks are already waiting
+    bool post(thread_pool& pool, std::function<void()> task);
+
+private:
+    void drain();
+
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    bool scheduled = false;
+    size_t maxPending;
+};
+
+#endif // TASK_STRAND_H
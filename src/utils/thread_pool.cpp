@@ -38,6 +38,12 @@ thread_pool::thread_pool(size_t numThreads) : stop(false) {
 	}
 }
 
+size_t thread_pool::queued()
+{
+    std::lock_guard lock(queue_mutex);
+    return tasks.size();
+}
+
 // Destructor joins all threads
 thread_pool::~thread_pool()
 {
@@ -20,6 +20,9 @@ public:
     auto enqueue(F&& f, Args&&... args)
         -> std::future<std::result_of_t<F(Args...)>>;
 
+    // Number of tasks waiting for a worker
+    size_t queued();
+
     // Destructor: Joins all threads
     ~thread_pool();
 
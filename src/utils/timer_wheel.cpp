@@ -0,0 +1,118 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+TimerWheel::TimerWheel(Clock::duration tick, Clock::time_point start) : tick(std::max(tick, Clock::duration(1))), start(start) {
+}
+
+uint64_t TimerWheel::toTick(Clock::time_point time) const {
+    if (time <= start) {
+        return 0;
+    }
+    return static_cast<uint64_t>((time - start) / tick);
+}
+
+TimerWheel::Clock::time_point TimerWheel::toTime(uint64_t tickIndex) const {
+    return start + tick * static_cast<Clock::rep>(tickIndex);
+}
+
+TimerWheel::TimerID TimerWheel::schedule(Clock::time_point deadline, std::function<void()> callback) {
+    TimerID id = nextID++;
+    // Round up, a timer never fires early; a deadline in the past fires on the next tick
+    uint64_t deadlineTick = toTick(deadline);
+    if (toTime(deadlineTick) < deadline) {
+        ++deadlineTick;
+    }
+    deadlineTick = std::max(deadlineTick, currentTick + 1);
+
+    timers.emplace(id, Timer{deadlineTick, std::move(callback)});
+    place(id, deadlineTick);
+    return id;
+}
+
+void TimerWheel::cancel(TimerID id) {
+    timers.erase(id);
+}
+
+void TimerWheel::place(TimerID id, uint64_t deadline) {
+    uint64_t delta = deadline > currentTick ? deadline - currentTick : 0;
+    for (int level = 0; level < LEVELS; ++level) {
+        if (delta < (uint64_t{1} << (SLOT_BITS * (level + 1))) || level == LEVELS - 1) {
+            uint64_t slotTick = level == LEVELS - 1 ? std::min(deadline, currentTick + (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1) : deadline;
+            wheels[level][(slotTick >> (SLOT_BITS * level)) & SLOT_MASK].push_back(id);
+            return;
+        }
+    }
+}
+
+void TimerWheel::cascade(int level) {
+    std::vector<TimerID> slot;
+    slot.swap(wheels[level][(currentTick >> (SLOT_BITS * level)) & SLOT_MASK]);
+    // Moved one level down now that their deadline is closer
+    for (TimerID id : slot) {
+        auto it = timers.find(id);
+        if (it != timers.end()) {
+            place(id, it->second.deadline);
+        }
+    }
+}
+
+size_t TimerWheel::advance(Clock::time_point now) {
+    uint64_t target = toTick(now);
+    size_t fired = 0;
+    std::vector<TimerID> due;
+
+    while (currentTick < target) {
+        if (timers.empty()) {
+            // Nothing to cascade, jump straight to the present
+            for (auto& level : wheels) {
+                for (auto& slot : level) {
+                    slot.clear();
+                }
+            }
+            currentTick = target;
+            break;
+        }
+
+        ++currentTick;
+        for (int level = 1; level < LEVELS; ++level) {
+            if ((currentTick & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        due.clear();
+        due.swap(wheels[0][currentTick & SLOT_MASK]);
+        for (TimerID id : due) {
+            auto it = timers.find(id);
+            if (it == timers.end()) {
+                continue;
+            }
+            if (it->second.deadline > currentTick) {
+                // Deadline beyond the range of the last level, wait another round
+                place(id, it->second.deadline);
+                continue;
+            }
+            // The callback may schedule or cancel timers
+            std::function<void()> callback = std::move(it->second.callback);
+            timers.erase(it);
+            callback();
+            ++fired;
+        }
+    }
+    return fired;
+}
+
+TimerWheel::Clock::time_point TimerWheel::nextExpiry() const {
+    if (timers.empty()) {
+        return Clock::time_point::max();
+    }
+    for (uint64_t nextTick = currentTick + 1; nextTick <= currentTick + SLOTS; ++nextTick) {
+        // Higher levels cascade when the first level wraps around
+        if (!wheels[0][nextTick & SLOT_MASK].empty() || (nextTick & SLOT_MASK) == 0) {
+            return toTime(nextTick);
+        }
+    }
+    return toTime(currentTick + SLOTS);
+}
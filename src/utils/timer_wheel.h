@@ -0,0 +1,58 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// Hierarchical timing wheel for many coarse deadlines, e.g. keep-alives and connection timeouts.
+// Scheduling and cancelling are O(1), advancing only touches the timers that are due.
+// Not thread safe, it is meant to be owned by a single thread.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerID = uint64_t;
+
+    explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(100), Clock::time_point start = Clock::now());
+
+    // Run the callback on the first advance() at or after the deadline, rounded up to a whole tick
+    TimerID schedule(Clock::time_point deadline, std::function<void()> callback);
+    void cancel(TimerID id);
+
+    // Run every timer that is due, returns how many fired
+    size_t advance(Clock::time_point now);
+
+    // Earliest time advance() may have something to do, Clock::time_point::max() when idle
+    [[nodiscard]] Clock::time_point nextExpiry() const;
+    [[nodiscard]] size_t size() const { return timers.size(); }
+
+private:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint64_t SLOTS = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    // 64^4 ticks, about 19 days with 100 ms ticks; later deadlines wait on the last level
+    static constexpr int LEVELS = 4;
+
+    struct Timer {
+        uint64_t deadline;
+        std::function<void()> callback;
+    };
+
+    [[nodiscard]] uint64_t toTick(Clock::time_point time) const;
+    [[nodiscard]] Clock::time_point toTime(uint64_t tick) const;
+    void place(TimerID id, uint64_t deadline);
+    void cascade(int level);
+
+    Clock::duration tick;
+    Clock::time_point start;
+    uint64_t currentTick = 0;
+    TimerID nextID = 1;
+    // Cancelled timers are dropped from here, their slot entries are skipped lazily
+    std::unordered_map<TimerID, Timer> timers;
+    std::array<std::array<std::vector<TimerID>, SLOTS>, LEVELS> wheels;
+};
+
+#endif // TIMER_WHEEL_H
@@ -1,5 +1,6 @@
 #include "block_states.h"
 
+#include <algorithm>
 #include <iostream>
 #include <nlohmann/json.hpp>
 
@@ -9,6 +10,80 @@
 #include "data/data.h"
 #include "entities/player.h"
 
+static const std::string& getStateName(const BlockState& state) {
+    return std::visit([](const auto& s) -> const std::string& { return s.name; }, state);
+}
+
+static size_t getStateValueCount(const BlockState& state) {
+    if (auto enumState = std::get_if<EnumState>(&state)) {
+        return enumState->values.size();
+    }
+    if (auto intState = std::get_if<IntState>(&state)) {
+        return intState->maxValue - intState->minValue + 1;
+    }
+    return 2;
+}
+
+// Same value order as calculateBlockStateID, booleans start with true
+static std::string getStateValue(const BlockState& state, size_t valueIndex) {
+    if (auto enumState = std::get_if<EnumState>(&state)) {
+        return enumState->values[valueIndex];
+    }
+    if (auto intState = std::get_if<IntState>(&state)) {
+        return std::to_string(intState->minValue + static_cast<int>(valueIndex));
+    }
+    return valueIndex == 0 ? "true" : "false";
+}
+
+// Value index of every state of the block, the last state varies fastest
+static std::vector<size_t> decodeBlockState(const BlockData& blockData, int32_t blockStateID) {
+    std::vector<size_t> valueIndices(blockData.states.size());
+    size_t index = static_cast<size_t>(std::max(blockStateID - blockData.minStateId, 0));
+    for (size_t i = blockData.states.size(); i-- > 0;) {
+        size_t count = getStateValueCount(blockData.states[i]);
+        valueIndices[i] = index % count;
+        index /= count;
+    }
+    return valueIndices;
+}
+
+std::vector<std::pair<std::string, std::string>> getBlockStateProperties(const BlockData& blockData, int32_t blockStateID) {
+    std::vector<size_t> valueIndices = decodeBlockState(blockData, blockStateID);
+    std::vector<std::pair<std::string, std::string>> properties;
+    properties.reserve(blockData.states.size());
+    for (size_t i = 0; i < blockData.states.size(); ++i) {
+        properties.emplace_back(getStateName(blockData.states[i]), getStateValue(blockData.states[i], valueIndices[i]));
+    }
+    return properties;
+}
+
+std::optional<int32_t> getBlockStateID(const BlockData& blockData, const std::vector<std::pair<std::string, std::string>>& properties) {
+    std::vector<size_t> valueIndices = decodeBlockState(blockData, blockData.defaultState);
+    for (const auto& [name, value] : properties) {
+        auto state = std::ranges::find(blockData.states, name, getStateName);
+        if (state == blockData.states.end()) {
+            return std::nullopt;
+        }
+        size_t count = getStateValueCount(*state);
+        size_t valueIndex = 0;
+        while (valueIndex < count && getStateValue(*state, valueIndex) != value) {
+            ++valueIndex;
+        }
+        if (valueIndex == count) {
+            return std::nullopt;
+        }
+        valueIndices[state - blockData.states.begin()] = valueIndex;
+    }
+
+    size_t index = 0;
+    size_t multiplier = 1;
+    for (size_t i = blockData.states.size(); i-- > 0;) {
+        index += valueIndices[i] * multiplier;
+        multiplier *= getStateValueCount(blockData.states[i]);
+    }
+    return blockData.minStateId + static_cast<int32_t>(index);
+}
+
 bool isBlockWater(const Position & pos) {
     // TODO: Implement this function
     return false;
@@ -1,6 +1,7 @@
 #ifndef BLOCK_STATES_H
 #define BLOCK_STATES_H
 #include <memory>
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -76,6 +77,10 @@ struct BoolState {
 using BlockState = std::variant<EnumState, IntState, BoolState>;
 
 size_t calculateBlockStateID(const BlockData& blockData, std::vector<BlockState>& currentBlockState);
+// Property names and values of a block state, in the order of the block's states
+std::vector<std::pair<std::string, std::string>> getBlockStateProperties(const BlockData& blockData, int32_t blockStateID);
+// Block state with the given properties, the others at their default; nothing if a name or value is unknown
+std::optional<int32_t> getBlockStateID(const BlockData& blockData, const std::vector<std::pair<std::string, std::string>>& properties);
 std::vector<BlockState> getBlockStates(const nlohmann::basic_json<> & states);
 void assignCurrenBlockStates(const BlockData& blockData, const std::shared_ptr<Player>& player, const Position& pos, Face faceClicked, const Position &cursorPos, std::vector<BlockState>& currentBlockState);
 
@@ -51,13 +51,8 @@ void Bossbar::setVisible(bool visible) {
         return;
     }
     this->visible = visible;
-    for (auto& player : players) {
-        if (visible) {
-            sendBossbar(*this, 0);
-        } else {
-            sendBossbar(*this, 1);
-        }
-    }
+    // sendBossbar already reaches every player of the bar
+    sendBossbar(*this, visible ? 0 : 1);
 }
 
 void Bossbar::addPlayer(const std::string &playerName) {
@@ -67,9 +62,7 @@ void Bossbar::addPlayer(const std::string &playerName) {
 }
 
 void Bossbar::removeAllPlayers() {
-    for (auto& player : players) {
-        sendBossbar(*this, 1);
-    }
+    sendBossbar(*this, 1);
     players.clear();
 }
 
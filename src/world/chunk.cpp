@@ -2,6 +2,8 @@
 
 #include <bitset>
 #include <iostream>
+#include <map>
+#include <ranges>
 #include <tag_array.h>
 #include <tag_list.h>
 #include <tag_string.h>
@@ -10,7 +12,9 @@
 
 #include "core/config.h"
 #include "networking/network.h"
+#include "networking/packet_ids.h"
 #include "entities/player.h"
+#include "chunk_tickets.h"
 #include "region_file.h"
 #include "core/server.h"
 #include "core/utils.h"
@@ -205,6 +209,7 @@ void Chunk::setBlock(int32_t x, int32_t y, int32_t z, int32_t blockStateID, bool
 
 void Chunk::markDirty() {
     dirty = true;
+    dataPacket.reset();
 }
 
 int32_t getLocalCoordinate(int32_t coord) {
@@ -296,35 +301,26 @@ std::vector<ChunkCoordinates> getChunksInView(int32_t centerChunkX, int32_t cent
     return chunks;
 }
 
-void updatePlayerChunkView(const std::shared_ptr<Player> & player, int32_t oldChunkX, int32_t oldChunkZ, int32_t newChunkX, int32_t newChunkZ) {
-    // Step 1: Determine old and new viewed chunks based on view distance
-    std::vector<ChunkCoordinates> oldViewedChunks{};
-    if(oldChunkX != -1 || oldChunkZ != -1) {
-        oldViewedChunks = getChunksInView(oldChunkX, oldChunkZ, serverConfig.viewDistance);
-    }
-    std::vector<ChunkCoordinates> newViewedChunks = getChunksInView(newChunkX, newChunkZ, serverConfig.viewDistance);
-
-    // Step 2: Convert vectors to sets for easy comparison
-    std::unordered_set<ChunkCoordinates> oldSet(oldViewedChunks.begin(), oldViewedChunks.end());
-    std::unordered_set<ChunkCoordinates> newSet(newViewedChunks.begin(), newViewedChunks.end());
-
-    // Step 3: Determine chunks to add and remove
+void updatePlayerChunkView(const std::shared_ptr<Player> & player, int32_t newChunkX, int32_t newChunkZ, int viewDistance) {
+    // Step 1: Determine the newly viewed chunks based on the player's view distance
     std::vector<ChunkCoordinates> chunksToAdd;
-    std::vector<ChunkCoordinates> chunksToRemove;
-
-    for (const auto & chunk : oldSet) {
-        if (!newSet.contains(chunk)) {
-            chunksToRemove.emplace_back(chunk);
+    for (const auto & chunk : getChunksInView(newChunkX, newChunkZ, viewDistance)) {
+        if (!player->currentViewedChunks.contains(chunk)) {
+            chunksToAdd.emplace_back(chunk);
         }
     }
 
-    for (const auto & chunk : newSet) {
-        if (!oldSet.contains(chunk)) {
-            chunksToAdd.emplace_back(chunk);
+    // Step 2: Chunks are dropped only beyond the unload margin, like the client's copy of them,
+    // so the client keeps receiving updates for every chunk it still has
+    std::vector<ChunkCoordinates> chunksToRemove;
+    int unloadDistance = viewDistance + CHUNK_UNLOAD_MARGIN;
+    for (const auto & chunk : player->currentViewedChunks) {
+        if (std::abs(chunk.chunkX - newChunkX) > unloadDistance || std::abs(chunk.chunkZ - newChunkZ) > unloadDistance) {
+            chunksToRemove.emplace_back(chunk);
         }
     }
 
-    // Step 4: Update the chunkViewersMap
+    // Step 3: Update the chunkViewersMap
     {
         std::lock_guard lock(chunkViewersMutex);
 
@@ -353,6 +349,14 @@ void updatePlayerChunkView(const std::shared_ptr<Player> & player, int32_t oldCh
             player->currentViewedChunks.emplace(coords);
         }
     }
+
+    // Step 4: Move the tickets, never under the viewers lock, which chunk updates take while holding the chunk lock
+    for (const auto & coords : chunksToAdd) {
+        chunkTickets.add(coords.chunkX, coords.chunkZ);
+    }
+    for (const auto & coords : chunksToRemove) {
+        chunkTickets.remove(coords.chunkX, coords.chunkZ);
+    }
 }
 
 
@@ -796,13 +800,7 @@ std::shared_ptr<Chunk> getChunkContainingBlock(int32_t x, int32_t y, int32_t z)
     int32_t chunkX = getChunkCoordinate(x);
     int32_t chunkZ = getChunkCoordinate(z);
 
-    // Access the global chunk map (thread-safe)
-    std::lock_guard lock(chunkMapMutex);
-    auto it = globalChunkMap.find({chunkX, chunkZ});
-    if (it != globalChunkMap.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return globalChunkMap.find(chunkX, chunkZ);
 }
 
 void notifyChunkUpdate(const std::shared_ptr<Chunk>& chunk, int32_t x, int32_t y, int32_t z) {
@@ -831,27 +829,57 @@ void notifyChunkUpdate(const std::shared_ptr<Chunk>& chunk, int32_t x, int32_t y
         std::lock_guard lock(chunkViewersMutex);
         auto it = chunkViewersMap.find(chunkCoords);
         if (it != chunkViewersMap.end()) {
+            EncodedPacket packet(std::move(packetData));
             for (const auto& player : it->second) {
-                sendPacket(*player->client, packetData);
+                sendPacket(*player->client, packet);
             }
         }
     }
 }
 
-void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk>& chunk) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(0x27); // Packet ID for Chunk Data
-
-    // Chunk X and Z
-    writeInt(packetData, chunk->chunkX);
-    writeInt(packetData, chunk->chunkZ);
+std::shared_ptr<EncodedPacket> prepareChunkDataPacket(const std::shared_ptr<Chunk>& chunk, bool compressionEnabled) {
+    std::shared_ptr<EncodedPacket> packet;
+    {
+        std::lock_guard lock(chunk->mutex);
+        packet = chunk->dataPacket;
+        if (!packet) {
+            PacketWriter packetData;
+            packetData.push_back(CHUNK_DATA);
+
+            // Chunk X and Z
+            writeInt(packetData, chunk->chunkX);
+            writeInt(packetData, chunk->chunkZ);
+
+            // Serialize the chunk data using the updated function
+            std::vector<uint8_t> serializedChunkData = serializeChunkData(chunk);
+            writeBytes(packetData, serializedChunkData);
+
+            packet = std::make_shared<EncodedPacket>(std::move(packetData), CompressionProfile::Chunk);
+            chunk->dataPacket = packet;
+        }
+    }
 
-    // Serialize the chunk data using the updated function
-    std::vector<uint8_t> serializedChunkData = serializeChunkData(chunk);
-    writeBytes(packetData, serializedChunkData);
+    // Compressed once, without the chunk lock, so block changes on the chunk don't wait for the deflate.
+    // The viewers after the first one only get it encrypted.
+    try {
+        packet->frame(compressionEnabled);
+    } catch (const std::exception& e) {
+        logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
+        return nullptr;
+    }
+    return packet;
+}
 
-    // Send the packet to the player
-    sendPacket(client, packetData);
+void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk>& chunk) {
+    while (auto packet = prepareChunkDataPacket(chunk, client.compressionEnabled)) {
+        // Queued under the lock, so a block change made meanwhile reaches the client after it.
+        // If the chunk changed while the packet was compressed, it is built again.
+        std::lock_guard lock(chunk->mutex);
+        if (chunk->dataPacket == packet) {
+            sendPacket(client, *packet);
+            return;
+        }
+    }
 }
 
 std::shared_ptr<Chunk> generateFlatChunk(const FlatWorldSettings& settings, int32_t chunkX, int32_t chunkZ, int& highestY) {
@@ -975,6 +1003,21 @@ std::vector<int32_t> unpackPackedData(const std::vector<uint64_t>& packedData, i
     return indices;
 }
 
+// Block state of a block_states palette entry, nothing if the block or one of its properties is unknown
+static std::optional<int32_t> readPaletteEntry(const nbt::tag_compound& entry) {
+    auto block = blocks.find(stripNamespace(entry.at("Name").as<nbt::tag_string>().get()));
+    if (block == blocks.end()) {
+        return std::nullopt;
+    }
+    std::vector<std::pair<std::string, std::string>> properties;
+    if (entry.has_key("Properties")) {
+        for (const auto& [name, value] : entry.at("Properties").as<nbt::tag_compound>()) {
+            properties.emplace_back(name, value.as<nbt::tag_string>().get());
+        }
+    }
+    return getBlockStateID(block->second, properties);
+}
+
 std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ) {
     // Determine the region coordinates
     int regionX = chunkX >> 5;
@@ -984,19 +1027,14 @@ std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ) {
     int localX = chunkX & 31;
     int localZ = chunkZ & 31;
 
-    // Construct the region file path
-    std::filesystem::path regionPath = "world/region/r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".mca"; // Replace with actual path
-
-    // Check if the region file exists
-    if (!exists(regionPath)) {
+    // The region file, if it exists
+    std::shared_ptr<RegionFile> regionFile = regionFileCache.get(regionX, regionZ, false);
+    if (!regionFile) {
         return nullptr;
     }
 
-    // Open the region file
-    RegionFile regionFile(regionPath, true);
-
     // Load the chunk
-    std::optional<ChunkData> chunkDataOpt = regionFile.loadChunk(localX, localZ, regionX, regionZ);
+    std::optional<ChunkData> chunkDataOpt = regionFile->loadChunk(localX, localZ, regionX, regionZ);
     if (!chunkDataOpt.has_value()) {
         logMessage("Chunk (" + std::to_string(chunkX) + ", " + std::to_string(chunkZ) + ") not found in region file.", LOG_WARNING);
         return nullptr;
@@ -1033,9 +1071,11 @@ std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ) {
                 if (blockStatesCompound.has_key("palette")) {
                     const auto& paletteList = blockStatesCompound.at("palette").as<nbt::tag_list>();
                     for (const auto& paletteEntry : paletteList) {
-                        const std::string& blockName = paletteEntry.as<nbt::tag_compound>().at("Name").as<nbt::tag_string>().get();
-                        int32_t blockStateID = blocks[stripNamespace(blockName)].defaultState;
-                        section.palette.getIndex(blockStateID); // Populate the palette
+                        std::optional<int32_t> blockStateID = readPaletteEntry(paletteEntry.as<nbt::tag_compound>());
+                        if (!blockStateID.has_value()) {
+                            chunk->lossyLoad = true;
+                        }
+                        section.palette.getIndex(blockStateID.value_or(0)); // Populate the palette
                     }
                 }
 
@@ -1083,7 +1123,11 @@ std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ) {
                     const auto& biomePaletteList = biomesCompound.at("palette").as<nbt::tag_list>();
                     for (const auto& biomeEntry : biomePaletteList) {
                         const std::string& biomeName = biomeEntry.as<nbt::tag_string>().get();
-                        int32_t biomeID = biomes[stripNamespace(biomeName)].id;
+                        auto biome = biomes.find(stripNamespace(biomeName));
+                        if (biome == biomes.end()) {
+                            chunk->lossyLoad = true;
+                        }
+                        int32_t biomeID = biome != biomes.end() ? biome->second.id : 0;
                         section.biomePalette.getIndex(biomeID); // Populate the biome palette
                     }
                 }
@@ -1146,14 +1190,267 @@ std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ) {
     return chunk;
 }
 
-std::shared_ptr<Chunk> getOrLoadChunk(int32_t chunkX, int32_t chunkZ) {
-    ChunkCoordinates coords{chunkX, chunkZ};
-    {
-        std::lock_guard lock(chunkMapMutex);
-        auto it = globalChunkMap.find(coords);
-        if (it != globalChunkMap.end()) {
-            return it->second;
+// Entry of an LSB-first bit stream, the in-memory layout of the section indices
+static int32_t readPackedIndex(const std::vector<uint8_t>& packed, int bitsPerEntry, int index) {
+    int32_t value = 0;
+    int bitOffset = index * bitsPerEntry;
+    for (int i = 0; i < bitsPerEntry; ++i) {
+        size_t byteIndex = (bitOffset + i) / 8;
+        if (byteIndex >= packed.size()) {
+            break;
+        }
+        value |= ((packed[byteIndex] >> ((bitOffset + i) % 8)) & 1) << i;
+    }
+    return value;
+}
+
+// Region file layout: as many entries as fit in each long, none spanning two longs
+static std::vector<int64_t> packLongArray(const std::vector<int32_t>& values, int bitsPerEntry) {
+    int entriesPerLong = 64 / bitsPerEntry;
+    std::vector<int64_t> longs((values.size() + entriesPerLong - 1) / entriesPerLong);
+    for (size_t i = 0; i < values.size(); ++i) {
+        longs[i / entriesPerLong] |= static_cast<int64_t>(static_cast<uint64_t>(values[i]) << ((i % entriesPerLong) * bitsPerEntry));
+    }
+    return longs;
+}
+
+// Block a state belongs to, nullptr for unknown states
+static const std::pair<const std::string, BlockData>* getBlockOfState(int32_t blockStateID) {
+    static const std::unordered_map<int32_t, const std::pair<const std::string, BlockData>*> blocksByState = [] {
+        std::unordered_map<int32_t, const std::pair<const std::string, BlockData>*> byState;
+        for (const auto& block : blocks) {
+            for (int state = block.second.minStateId; state <= block.second.maxStateId; ++state) {
+                byState[state] = &block;
+            }
+        }
+        return byState;
+    }();
+    auto it = blocksByState.find(blockStateID);
+    return it != blocksByState.end() ? it->second : nullptr;
+}
+
+static nbt::tag_compound createPaletteEntry(int32_t blockStateID) {
+    nbt::tag_compound entry;
+    const auto* block = getBlockOfState(blockStateID);
+    if (!block) {
+        entry["Name"] = nbt::tag_string("minecraft:air");
+        return entry;
+    }
+    entry["Name"] = nbt::tag_string("minecraft:" + block->first);
+    if (!block->second.states.empty()) {
+        nbt::tag_compound properties;
+        for (auto& [name, value] : getBlockStateProperties(block->second, blockStateID)) {
+            properties[name] = nbt::tag_string(std::move(value));
+        }
+        entry["Properties"] = std::move(properties);
+    }
+    return entry;
+}
+
+static std::string getBiomeName(int32_t biomeID) {
+    for (const auto& [name, biome] : biomes) {
+        if (biome.id == biomeID) {
+            return name;
+        }
+    }
+    return "plains";
+}
+
+// Data version of the chunks this server creates (1.21.3)
+constexpr int32_t CHUNK_DATA_VERSION = 4082;
+
+// The counterpart of loadChunkFromDisk: writes the blocks, biomes, light and heightmaps of the chunk into its region compound.
+// Everything else already in the compound, e.g. DataVersion, block entities and the light-only sections
+// above and below the world, is kept as it was.
+static void writeChunkTags(nbt::tag_compound& root, const std::shared_ptr<Chunk>& chunk) {
+    constexpr int BLOCKS_PER_SECTION = CHUNK_WIDTH * CHUNK_LENGTH * SECTION_HEIGHT;
+    constexpr int BIOMES_PER_SECTION = 64;
+
+    if (!root.has_key("DataVersion")) {
+        // A chunk the server created itself
+        root["DataVersion"] = nbt::tag_int(CHUNK_DATA_VERSION);
+        root["xPos"] = nbt::tag_int(chunk->chunkX);
+        root["zPos"] = nbt::tag_int(chunk->chunkZ);
+        root["yPos"] = nbt::tag_int(MIN_Y / SECTION_HEIGHT);
+        root["Status"] = nbt::tag_string("minecraft:full");
+    }
+
+    // The sections already stored, by Y
+    std::map<int8_t, nbt::tag_compound> storedSections;
+    if (root.has_key("sections")) {
+        for (auto& sectionTag : root.at("sections").as<nbt::tag_list>()) {
+            auto& sectionCompound = sectionTag.as<nbt::tag_compound>();
+            if (sectionCompound.has_key("Y")) {
+                int8_t sectionY = sectionCompound.at("Y").as<nbt::tag_byte>().get();
+                storedSections[sectionY] = std::move(sectionCompound);
+            }
+        }
+    }
+
+    for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS; ++sectionIndex) {
+        const auto& sectionOpt = chunk->sections[sectionIndex];
+        if (!sectionOpt.has_value()) {
+            continue;
+        }
+        const MemChunkSection& section = sectionOpt.value();
+
+        auto sectionY = static_cast<int8_t>(sectionIndex + MIN_Y / SECTION_HEIGHT);
+        nbt::tag_compound& sectionCompound = storedSections[sectionY];
+        sectionCompound["Y"] = nbt::tag_byte(sectionY);
+
+        nbt::tag_compound blockStates;
+        nbt::tag_list palette;
+        size_t paletteSize = section.palette.indexToBlockState.size();
+        if (paletteSize == 0 || (paletteSize > 1 && section.blockIndices.empty())) {
+            palette.push_back(createPaletteEntry(0));
+        } else {
+            for (int32_t blockStateID : section.palette.indexToBlockState) {
+                palette.push_back(createPaletteEntry(blockStateID));
+            }
+            if (paletteSize > 1) {
+                std::vector<int32_t> indices(BLOCKS_PER_SECTION);
+                for (int i = 0; i < BLOCKS_PER_SECTION; ++i) {
+                    indices[i] = section.getBlockIndex(i);
+                }
+                blockStates["data"] = nbt::tag_long_array(packLongArray(indices, calculateBitsPerEntry(section.palette)));
+            }
+        }
+        blockStates["palette"] = std::move(palette);
+        sectionCompound["block_states"] = std::move(blockStates);
+
+        if (!section.biomePalette.indexToBlockState.empty()) {
+            nbt::tag_compound biomeStates;
+            nbt::tag_list biomePalette;
+            for (int32_t biomeID : section.biomePalette.indexToBlockState) {
+                biomePalette.push_back(nbt::tag_string("minecraft:" + getBiomeName(biomeID)));
+            }
+            if (section.biomePalette.indexToBlockState.size() > 1) {
+                int storedBits = calculateBitsPerEntry(section.biomePalette);
+                std::vector<int32_t> indices(BIOMES_PER_SECTION);
+                for (int i = 0; i < BIOMES_PER_SECTION; ++i) {
+                    indices[i] = readPackedIndex(section.biomeIndices, storedBits, i);
+                }
+                biomeStates["data"] = nbt::tag_long_array(packLongArray(indices, calculateBitsPerEntry(section.biomePalette, 1)));
+            }
+            biomeStates["palette"] = std::move(biomePalette);
+            sectionCompound["biomes"] = std::move(biomeStates);
+        }
+
+        if (!section.lighting.blockLight.empty()) {
+            sectionCompound["BlockLight"] = nbt::tag_byte_array(std::vector<int8_t>(section.lighting.blockLight.begin(), section.lighting.blockLight.end()));
+        }
+        if (!section.lighting.skyLight.empty()) {
+            sectionCompound["SkyLight"] = nbt::tag_byte_array(std::vector<int8_t>(section.lighting.skyLight.begin(), section.lighting.skyLight.end()));
+        }
+    }
+
+    nbt::tag_list sections;
+    for (auto& sectionCompound : storedSections | std::views::values) {
+        sections.push_back(std::move(sectionCompound));
+    }
+    root["sections"] = std::move(sections);
+
+    // Heightmap types the server doesn't keep stay as they were
+    nbt::tag_compound heightmaps = serializeHeightmaps(chunk);
+    if (root.has_key("Heightmaps")) {
+        for (auto& [name, heightmap] : root.at("Heightmaps").as<nbt::tag_compound>()) {
+            if (!heightmaps.has_key(name)) {
+                heightmaps[name] = std::move(heightmap);
+            }
+        }
+    }
+    root["Heightmaps"] = std::move(heightmaps);
+}
+
+std::optional<ChunkSnapshot> snapshotChunk(const std::shared_ptr<Chunk>& chunk) {
+    auto copy = std::make_shared<Chunk>(chunk->chunkX, chunk->chunkZ);
+    std::lock_guard lock(chunk->mutex);
+    if (!chunk->dirty) {
+        return std::nullopt;
+    }
+    copy->sections = chunk->sections;
+    copy->heightmaps = chunk->heightmaps;
+    chunk->dirty = false;
+    return ChunkSnapshot{chunk, std::move(copy), ++chunk->snapshotVersion};
+}
+
+bool writeChunkSnapshot(const ChunkSnapshot& snapshot) {
+    const std::shared_ptr<Chunk>& chunk = snapshot.chunk;
+    int regionX = chunk->chunkX >> 5;
+    int regionZ = chunk->chunkZ >> 5;
+    int localX = chunk->chunkX & 31;
+    int localZ = chunk->chunkZ & 31;
+
+    std::lock_guard saveLock(chunk->saveMutex);
+    // A later snapshot of the chunk is on disk already
+    if (snapshot.version <= chunk->writtenVersion) {
+        return true;
+    }
+    if (chunk->lossyLoad) {
+        // Counted as written, so the chunk can still be unloaded
+        logMessage("Not saving chunk (" + std::to_string(chunk->chunkX) + ", " + std::to_string(chunk->chunkZ) + "), it has blocks or biomes this server doesn't know", LOG_WARNING);
+        chunk->writtenVersion = snapshot.version;
+        return true;
+    }
+
+    std::shared_ptr<RegionFile> regionFile = regionFileCache.get(regionX, regionZ, true);
+    bool saved = false;
+    if (regionFile) {
+        // The stored compound is updated in place, so the tags the server doesn't handle survive the save
+        std::optional<ChunkData> chunkData = regionFile->hasChunk(localX, localZ)
+            ? regionFile->loadChunk(localX, localZ, regionX, regionZ)
+            : std::optional(ChunkData{});
+        if (!chunkData.has_value()) {
+            logMessage("Not overwriting unreadable chunk (" + std::to_string(chunk->chunkX) + ", " + std::to_string(chunk->chunkZ) + ")", LOG_ERROR);
+        } else {
+            writeChunkTags(chunkData->nbt, snapshot.copy);
+            chunkData->heightmaps = snapshot.copy->heightmaps;
+            saved = regionFile->saveChunk(localX, localZ, regionX, regionZ, chunkData.value());
+        }
+    }
+
+    if (saved) {
+        chunk->writtenVersion = snapshot.version;
+    } else {
+        logMessage("Failed to save chunk (" + std::to_string(chunk->chunkX) + ", " + std::to_string(chunk->chunkZ) + ")", LOG_ERROR);
+        std::lock_guard lock(chunk->mutex);
+        chunk->dirty = true;
+    }
+    return saved;
+}
+
+bool saveChunkToDisk(const std::shared_ptr<Chunk>& chunk) {
+    std::optional<ChunkSnapshot> snapshot = snapshotChunk(chunk);
+    return !snapshot.has_value() || writeChunkSnapshot(snapshot.value());
+}
+
+size_t Chunk::memoryUsage() const {
+    size_t bytes = sizeof(Chunk);
+    for (const auto& sectionOpt : sections) {
+        if (!sectionOpt.has_value()) {
+            continue;
         }
+        const MemChunkSection& section = sectionOpt.value();
+        bytes += section.blockIndices.capacity() + section.tempBlockIndices.capacity()
+            + section.biomeIndices.capacity() + section.tempBiomeIndices.capacity()
+            + section.lighting.blockLight.capacity() + section.lighting.skyLight.capacity()
+            + (section.palette.indexToBlockState.capacity() + section.biomePalette.indexToBlockState.capacity()) * sizeof(int32_t)
+            // Rough size of a hash map node
+            + (section.palette.blockStateToIndex.size() + section.biomePalette.blockStateToIndex.size()) * 32;
+    }
+    for (const auto& heightmap : heightmaps.data | std::views::values) {
+        bytes += heightmap.capacity() * sizeof(int64_t);
+    }
+    if (dataPacket) {
+        // The payload and its compressed frame, which is not larger
+        bytes += 2 * dataPacket->payloadSize();
+    }
+    return bytes;
+}
+
+std::shared_ptr<Chunk> getOrLoadChunk(int32_t chunkX, int32_t chunkZ) {
+    if (auto chunk = globalChunkMap.find(chunkX, chunkZ)) {
+        return chunk;
     }
 
     // Load or generate the chunk outside the lock to prevent blocking other threads
@@ -1166,12 +1463,8 @@ std::shared_ptr<Chunk> getOrLoadChunk(int32_t chunkX, int32_t chunkZ) {
         }
     }
 
-    {
-        std::lock_guard lock(chunkMapMutex);
-        globalChunkMap[coords] = chunk;
-    }
-
-    return chunk;
+    // Another thread may have loaded the same chunk meanwhile, everyone has to use the same copy
+    return globalChunkMap.insert(chunkX, chunkZ, std::move(chunk));
 }
 
 bool sendCurrentChunkToPlayer(ClientConnection& client, int chunkX, int chunkZ) {
@@ -1183,8 +1476,6 @@ bool sendCurrentChunkToPlayer(ClientConnection& client, int chunkX, int chunkZ)
 
     // Serialize and send the current chunk
     sendChunkDataToPlayer(client, currentChunk);
-
-    globalChunkMap[ChunkCoordinates{chunkX, chunkZ}] = currentChunk;
     return true;
 }
 
@@ -1,11 +1,13 @@
 #ifndef CHUNK_H
 #define CHUNK_H
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "block_states.h"
+#include "chunk_map.h"
 #include "flatworld.h"
 #include "networking/network.h"
 #include "region_file.h"
@@ -13,6 +15,9 @@
 
 struct Player;
 constexpr int MIN_Y = -64;
+// Chunks stay loaded on the client this far beyond the view distance,
+// so walking back and forth over a chunk border doesn't unload and resend a whole row
+constexpr int CHUNK_UNLOAD_MARGIN = 2;
 constexpr int CHUNK_WIDTH = 16;
 constexpr int CHUNK_HEIGHT = 384;
 constexpr int CHUNK_LENGTH = 16;
@@ -70,12 +75,25 @@ struct Chunk {
     std::mutex mutex;
     bool dirty;
     Heightmaps heightmaps;
+    // Snapshots taken for saving are numbered, so an older one never overwrites a newer one on disk
+    uint64_t snapshotVersion = 0;
+    // Held while a snapshot is written
+    std::mutex saveMutex;
+    std::atomic<uint64_t> writtenVersion{0};
+    // Chunk Data packet shared by every viewer, built on first send and dropped by markDirty.
+    // Any change to the sections, their light or the heightmaps must go through markDirty, or viewers get a stale packet.
+    std::shared_ptr<EncodedPacket> dataPacket;
+    // Loaded with blocks, properties or biomes this server doesn't know; saving would lose them, so it is never saved
+    bool lossyLoad = false;
 
     Chunk(int32_t x, int32_t z) : chunkX(x), chunkZ(z), dirty(false) {}
 
     Block getBlock(int32_t x, int32_t y, int32_t z) const;
     void setBlock(int32_t x, int32_t y, int32_t z, int32_t blockStateID, bool adjustY = false);
+    // Blocks or light changed: the chunk needs saving and its Chunk Data packet is rebuilt
     void markDirty();
+    // Approximate heap size of the chunk, for the memory budget of loaded chunks
+    [[nodiscard]] size_t memoryUsage() const;
 };
 
 struct ChunkCoordinates {
@@ -93,12 +111,11 @@ struct ChunkCoordinates {
 template <>
 struct std::hash<ChunkCoordinates> {
     std::size_t operator()(const ChunkCoordinates& coords) const noexcept {
-        return ((std::hash<int32_t>()(coords.chunkX) ^ (std::hash<int32_t>()(coords.chunkZ) << 1)) >> 1);
+        return mixChunkKey(packChunkCoordinates(coords.chunkX, coords.chunkZ));
     }
 };
 
-inline std::unordered_map<ChunkCoordinates, std::shared_ptr<Chunk>, std::hash<ChunkCoordinates>> globalChunkMap;
-inline std::mutex chunkMapMutex;
+inline ChunkMap globalChunkMap;
 
 // Global map from ChunkCoordinates to players viewing them
 inline std::unordered_map<ChunkCoordinates, std::vector<std::shared_ptr<Player>>, std::hash<ChunkCoordinates>> chunkViewersMap;
@@ -109,9 +126,23 @@ int calculateBitsPerEntry(const Palette& palette, int min = 4);
 std::vector<uint8_t> encodeBlockIndices(const std::vector<uint8_t>& indices, int bitsPerEntry);
 std::shared_ptr<Chunk> getChunkContainingBlock(int32_t x, int32_t y, int32_t z);
 void notifyChunkUpdate(const std::shared_ptr<Chunk> & chunk, int32_t x, int32_t y, int32_t z);
-void updatePlayerChunkView(const std::shared_ptr<Player> & player, int32_t oldChunkX, int32_t oldChunkZ, int32_t newChunkX, int32_t newChunkZ);
+void updatePlayerChunkView(const std::shared_ptr<Player> & player, int32_t newChunkX, int32_t newChunkZ, int viewDistance);
 std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ);
+// Copy of the blocks of a dirty chunk as they were when the save started
+struct ChunkSnapshot {
+    std::shared_ptr<Chunk> chunk;
+    std::shared_ptr<Chunk> copy;
+    uint64_t version;
+};
+// Copies the chunk and clears its dirty flag, nothing if there are no unsaved changes
+std::optional<ChunkSnapshot> snapshotChunk(const std::shared_ptr<Chunk>& chunk);
+// Serializes the snapshot into its region file, the chunk is marked dirty again if that fails
+bool writeChunkSnapshot(const ChunkSnapshot& snapshot);
+// Snapshots and writes the chunk on the calling thread
+bool saveChunkToDisk(const std::shared_ptr<Chunk>& chunk);
 std::shared_ptr<Chunk> generateFlatChunk(const FlatWorldSettings& settings, int32_t chunkX, int32_t chunkZ, int& highestY);
+// Builds and compresses the chunk's shared Chunk Data packet if needed, without holding the chunk lock while compressing
+std::shared_ptr<EncodedPacket> prepareChunkDataPacket(const std::shared_ptr<Chunk>& chunk, bool compressionEnabled);
 void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk>& chunk);
 std::shared_ptr<Chunk> getOrLoadChunk(int32_t chunkX, int32_t chunkZ);
 bool sendCurrentChunkToPlayer(ClientConnection& client, int chunkX, int chunkZ);
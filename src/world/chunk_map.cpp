@@ -0,0 +1,106 @@
+#include "chunk_map.h"
+
+#include <mutex>
+
+ChunkMap::ChunkMap() {
+    for (auto& shard : shards) {
+        shard.slots.resize(INITIAL_CAPACITY);
+    }
+}
+
+size_t ChunkMap::findSlot(const Shard& shard, uint64_t key, uint64_t hash) {
+    size_t mask = shard.slots.size() - 1;
+    // The load factor is kept below 3/4, so there always is an empty slot to stop at
+    for (size_t index = hash & mask;; index = (index + 1) & mask) {
+        const Slot& slot = shard.slots[index];
+        if (!slot.chunk || slot.key == key) {
+            return index;
+        }
+    }
+}
+
+std::shared_ptr<Chunk> ChunkMap::find(int32_t chunkX, int32_t chunkZ) const {
+    uint64_t key = packChunkCoordinates(chunkX, chunkZ);
+    uint64_t hash = mixChunkKey(key);
+    const Shard& shard = shardFor(hash);
+    std::shared_lock lock(shard.mutex);
+    return shard.slots[findSlot(shard, key, hash)].chunk;
+}
+
+std::shared_ptr<Chunk> ChunkMap::insert(int32_t chunkX, int32_t chunkZ, std::shared_ptr<Chunk> chunk) {
+    if (!chunk) {
+        return nullptr;
+    }
+    uint64_t key = packChunkCoordinates(chunkX, chunkZ);
+    uint64_t hash = mixChunkKey(key);
+    Shard& shard = shardFor(hash);
+    std::unique_lock lock(shard.mutex);
+    Slot* slot = &shard.slots[findSlot(shard, key, hash)];
+    if (slot->chunk) {
+        return slot->chunk;
+    }
+    if ((shard.count + 1) * 4 > shard.slots.size() * 3) {
+        grow(shard);
+        slot = &shard.slots[findSlot(shard, key, hash)];
+    }
+    slot->key = key;
+    slot->chunk = std::move(chunk);
+    ++shard.count;
+    return slot->chunk;
+}
+
+bool ChunkMap::erase(int32_t chunkX, int32_t chunkZ) {
+    uint64_t key = packChunkCoordinates(chunkX, chunkZ);
+    uint64_t hash = mixChunkKey(key);
+    Shard& shard = shardFor(hash);
+    std::unique_lock lock(shard.mutex);
+    size_t mask = shard.slots.size() - 1;
+    size_t hole = findSlot(shard, key, hash);
+    if (!shard.slots[hole].chunk) {
+        return false;
+    }
+    shard.slots[hole].chunk.reset();
+    --shard.count;
+
+    // Backward shift deletion: move later entries of the probe run into the hole, so no tombstones are needed
+    for (size_t index = (hole + 1) & mask; shard.slots[index].chunk; index = (index + 1) & mask) {
+        size_t home = mixChunkKey(shard.slots[index].key) & mask;
+        // The entry can fill the hole unless its home slot lies cyclically in (hole, index]
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            shard.slots[hole] = std::move(shard.slots[index]);
+            shard.slots[index].chunk.reset();
+            hole = index;
+        }
+    }
+    return true;
+}
+
+size_t ChunkMap::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock lock(shard.mutex);
+        total += shard.count;
+    }
+    return total;
+}
+
+void ChunkMap::forEach(const std::function<void(const std::shared_ptr<Chunk>&)>& callback) const {
+    for (const auto& shard : shards) {
+        std::shared_lock lock(shard.mutex);
+        for (const auto& slot : shard.slots) {
+            if (slot.chunk) {
+                callback(slot.chunk);
+            }
+        }
+    }
+}
+
+void ChunkMap::grow(Shard& shard) {
+    std::vector<Slot> oldSlots = std::move(shard.slots);
+    shard.slots = std::vector<Slot>(oldSlots.size() * 2);
+    for (auto& slot : oldSlots) {
+        if (slot.chunk) {
+            shard.slots[findSlot(shard, slot.key, mixChunkKey(slot.key))] = std::move(slot);
+        }
+    }
+}
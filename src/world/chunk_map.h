@@ -0,0 +1,72 @@
+#ifndef CHUNK_MAP_H
+#define CHUNK_MAP_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+class Chunk;
+
+// Both coordinates in one key, Z in the low half
+inline uint64_t packChunkCoordinates(int32_t chunkX, int32_t chunkZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkZ);
+}
+
+// Spreads neighbouring chunks over the whole range (splitmix64 finalizer)
+inline uint64_t mixChunkKey(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+// Loaded chunks by coordinates, split into shards that are locked separately.
+// Lookups only take a shared lock on one shard, so readers on different threads never wait on each other,
+// and a chunk being inserted only blocks the lookups that land in the same shard.
+// Each shard is an open-addressing table with linear probing.
+class ChunkMap {
+public:
+    ChunkMap();
+
+    [[nodiscard]] std::shared_ptr<Chunk> find(int32_t chunkX, int32_t chunkZ) const;
+    // Inserts the chunk unless another thread did first; returns the chunk that ends up in the map
+    std::shared_ptr<Chunk> insert(int32_t chunkX, int32_t chunkZ, std::shared_ptr<Chunk> chunk);
+    bool erase(int32_t chunkX, int32_t chunkZ);
+
+    [[nodiscard]] size_t size() const;
+    // Visits every chunk, one shard at a time under its shared lock; the callback must not modify the map
+    void forEach(const std::function<void(const std::shared_ptr<Chunk>&)>& callback) const;
+
+private:
+    static constexpr int SHARD_BITS = 6;
+    static constexpr size_t SHARDS = 1 << SHARD_BITS;
+    static constexpr size_t INITIAL_CAPACITY = 64;
+
+    struct Slot {
+        uint64_t key = 0;
+        std::shared_ptr<Chunk> chunk;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        // Power-of-two sized, an empty slot has no chunk
+        std::vector<Slot> slots;
+        size_t count = 0;
+    };
+
+    // The shard comes from the high bits of the hash, the slot from the low bits
+    Shard& shardFor(uint64_t hash) { return shards[hash >> (64 - SHARD_BITS)]; }
+    const Shard& shardFor(uint64_t hash) const { return shards[hash >> (64 - SHARD_BITS)]; }
+    // Caller holds the shard's lock
+    static size_t findSlot(const Shard& shard, uint64_t key, uint64_t hash);
+    static void grow(Shard& shard);
+
+    std::array<Shard, SHARDS> shards;
+};
+
+#endif // CHUNK_MAP_H
@@ -0,0 +1,226 @@
+#include "chunk_sender.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+#include <ranges>
+
+#include "core/config.h"
+#include "core/server.h"
+#include "entities/player.h"
+#include "networking/client.h"
+#include "networking/clientbound_packets.h"
+#include "world/chunk_tickets.h"
+
+// Upper bound of the vanilla client's own estimate
+constexpr float MAX_CLIENT_CHUNKS_PER_TICK = 64.0f;
+constexpr float MIN_CLIENT_CHUNKS_PER_TICK = 0.01f;
+// Batches a client may have in flight once it reported its rate
+constexpr int MAX_UNACKNOWLEDGED_BATCHES = 10;
+// Chunks straight ahead count as this much closer, chunks behind as this much farther
+constexpr float LOOK_DIRECTION_WEIGHT = 0.25f;
+
+static std::atomic<uint64_t> chunksSent = 0;
+static std::atomic<uint64_t> batchesSent = 0;
+
+static float rateLimit() {
+    return std::clamp(static_cast<float>(serverConfig.maxChunksPerTick), 1.0f, MAX_CLIENT_CHUNKS_PER_TICK);
+}
+
+void ChunkSendQueue::enqueue(ChunkCoordinates coords) {
+    std::lock_guard lock(mutex);
+    pending.push_back(coords);
+    sorted = false;
+    peak = std::max(peak, pending.size());
+}
+
+std::vector<ChunkCoordinates> ChunkSendQueue::recenter(int32_t chunkX, int32_t chunkZ, int viewDistance, float yaw) {
+    std::vector<ChunkCoordinates> dropped;
+    std::lock_guard lock(mutex);
+    centerX = chunkX;
+    centerZ = chunkZ;
+    float yawRadians = yaw * std::numbers::pi_v<float> / 180.0f;
+    lookX = -std::sin(yawRadians);
+    lookZ = std::cos(yawRadians);
+
+    std::erase_if(pending, [&](const ChunkCoordinates& coords) {
+        if (std::abs(coords.chunkX - centerX) > viewDistance || std::abs(coords.chunkZ - centerZ) > viewDistance) {
+            dropped.push_back(coords);
+            return true;
+        }
+        return false;
+    });
+    sorted = false;
+    return dropped;
+}
+
+void ChunkSendQueue::sortPending() {
+    auto priority = [this](const ChunkCoordinates& coords) {
+        auto dx = static_cast<float>(coords.chunkX - centerX);
+        auto dz = static_cast<float>(coords.chunkZ - centerZ);
+        float distance = std::sqrt(dx * dx + dz * dz);
+        if (distance == 0.0f) {
+            return 0.0f;
+        }
+        float facing = (dx * lookX + dz * lookZ) / distance;
+        return distance * (1.0f - LOOK_DIRECTION_WEIGHT * facing);
+    };
+
+    std::vector<std::pair<float, ChunkCoordinates>> keyed;
+    keyed.reserve(pending.size());
+    for (const auto& coords : pending) {
+        keyed.emplace_back(priority(coords), coords);
+    }
+    std::ranges::sort(keyed, std::greater{}, [](const auto& entry) { return entry.first; });
+    for (size_t i = 0; i < keyed.size(); ++i) {
+        pending[i] = keyed[i].second;
+    }
+    sorted = true;
+}
+
+void ChunkSendQueue::clear() {
+    std::lock_guard lock(mutex);
+    pending.clear();
+}
+
+std::vector<ChunkCoordinates> ChunkSendQueue::takeBatch() {
+    std::vector<ChunkCoordinates> batch;
+    std::lock_guard lock(mutex);
+    if (batchInProgress || pending.empty() || unacknowledgedBatches >= maxUnacknowledgedBatches) {
+        return batch;
+    }
+
+    float rate = std::min(desiredChunksPerTick, rateLimit());
+    batchQuota = std::min(batchQuota + rate, std::max(1.0f, rate));
+    if (batchQuota < 1.0f) {
+        return batch;
+    }
+
+    if (!sorted) {
+        sortPending();
+    }
+    size_t count = std::min(pending.size(), static_cast<size_t>(batchQuota));
+    batch.assign(pending.rbegin(), pending.rbegin() + static_cast<std::ptrdiff_t>(count));
+    pending.erase(pending.end() - static_cast<std::ptrdiff_t>(count), pending.end());
+    batchQuota -= static_cast<float>(count);
+    ++unacknowledgedBatches;
+    batchInProgress = true;
+    return batch;
+}
+
+void ChunkSendQueue::finishBatch() {
+    std::lock_guard lock(mutex);
+    batchInProgress = false;
+}
+
+void ChunkSendQueue::onBatchReceived(float chunksPerTick) {
+    std::lock_guard lock(mutex);
+    unacknowledgedBatches = std::max(0, unacknowledgedBatches - 1);
+    desiredChunksPerTick = std::isnan(chunksPerTick) ? MIN_CLIENT_CHUNKS_PER_TICK : std::clamp(chunksPerTick, MIN_CLIENT_CHUNKS_PER_TICK, MAX_CLIENT_CHUNKS_PER_TICK);
+    if (unacknowledgedBatches == 0) {
+        batchQuota = 1.0f;
+    }
+    maxUnacknowledgedBatches = MAX_UNACKNOWLEDGED_BATCHES;
+}
+
+size_t ChunkSendQueue::size() const {
+    std::lock_guard lock(mutex);
+    return pending.size();
+}
+
+size_t ChunkSendQueue::peakSize() const {
+    std::lock_guard lock(mutex);
+    return peak;
+}
+
+float ChunkSendQueue::getChunksPerTick() const {
+    std::lock_guard lock(mutex);
+    return std::min(desiredChunksPerTick, rateLimit());
+}
+
+static void sendChunkBatch(const std::shared_ptr<ClientConnection>& connection, const std::shared_ptr<Player>& player, const std::vector<ChunkCoordinates>& batch) {
+    try {
+        sendChunkBatchStartPacket(*connection);
+        int32_t sent = 0;
+        for (const auto& coords : batch) {
+            // Keeps the chunk from being unloaded while it is sent
+            ChunkTicket ticket(coords.chunkX, coords.chunkZ);
+            auto chunk = getOrLoadChunk(coords.chunkX, coords.chunkZ);
+            if (!chunk) {
+                continue;
+            }
+            // Compressed before the player's lock is taken, sending below then only queues the cached packet
+            prepareChunkDataPacket(chunk, connection->compressionEnabled);
+            // The player may have moved on since the batch was taken; a chunk the client was told to unload
+            // must not be sent, or it would keep a chunk the server no longer tracks
+            std::lock_guard lock(player->loadedChunksMutex);
+            if (player->loadedChunks.contains(coords)) {
+                sendChunkDataToPlayer(*connection, chunk);
+                ++sent;
+            }
+        }
+        sendChunkBatchFinishedPacket(*connection, sent);
+        chunksSent += sent;
+        ++batchesSent;
+    } catch (const std::exception& e) {
+        logMessage("Failed to send chunk batch to " + player->name + ": " + e.what(), LOG_ERROR);
+    }
+    player->chunkQueue.finishBatch();
+
+    // Write the batch out now instead of at the end of the next tick
+    connectionReactor.post(connection, [] {});
+}
+
+void tickChunkSending() {
+    std::vector<std::shared_ptr<ClientConnection>> clients;
+    {
+        std::lock_guard lock(connectedClientsMutex);
+        clients.reserve(connectedClients.size());
+        for (const auto& client : connectedClients | std::views::values) {
+            clients.push_back(client);
+        }
+    }
+
+    for (const auto& connection : clients) {
+        std::shared_ptr<Player> player = connection->player;
+        if (!player || connection->connectionClosed) {
+            continue;
+        }
+        std::vector<ChunkCoordinates> batch = player->chunkQueue.takeBatch();
+        if (!batch.empty()) {
+            threadPool.enqueue([connection, player, batch = std::move(batch)] {
+                sendChunkBatch(connection, player, batch);
+            });
+        }
+    }
+}
+
+std::string formatChunkSendStats() {
+    size_t players = 0;
+    size_t queued = 0;
+    size_t longest = 0;
+    size_t peak = 0;
+    float rate = 0.0f;
+    {
+        std::lock_guard lock(playersMutex);
+        for (const auto& player : globalPlayers | std::views::values) {
+            size_t size = player->chunkQueue.size();
+            ++players;
+            queued += size;
+            longest = std::max(longest, size);
+            peak = std::max(peak, player->chunkQueue.peakSize());
+            rate += player->chunkQueue.getChunksPerTick();
+        }
+    }
+
+    std::string output = "Chunk sending: " + std::to_string(chunksSent.load()) + " chunks in " + std::to_string(batchesSent.load()) + " batches, "
+        + std::to_string(queued) + " queued (longest " + std::to_string(longest) + ", peak " + std::to_string(peak) + ")";
+    if (players > 0) {
+        char average[32];
+        std::snprintf(average, sizeof(average), "%.1f", rate / static_cast<float>(players));
+        output += ", " + std::string(average) + " chunks/tick on average";
+    }
+    return output + "\n";
+}
@@ -0,0 +1,58 @@
+#ifndef CHUNK_SENDER_H
+#define CHUNK_SENDER_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "chunk.h"
+
+// Chunks waiting to be sent to one player, nearest first.
+// They go out in batches wrapped in Chunk Batch Start/Finished, at the rate the client
+// reports back in Chunk Batch Received, so a slow client is never flooded with chunk data.
+class ChunkSendQueue {
+public:
+    void enqueue(ChunkCoordinates coords);
+    void clear();
+
+    // Orders the queue around a new center chunk, slightly favouring the chunks in front of the player.
+    // Chunks that left the view distance are dropped and returned, they were never sent.
+    std::vector<ChunkCoordinates> recenter(int32_t chunkX, int32_t chunkZ, int viewDistance, float yaw);
+
+    // Next batch if the client is ready for one, empty otherwise. Called once per tick.
+    std::vector<ChunkCoordinates> takeBatch();
+    // The batch taken last has been queued on the connection
+    void finishBatch();
+    void onBatchReceived(float chunksPerTick);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t peakSize() const;
+    [[nodiscard]] float getChunksPerTick() const;
+
+private:
+    // Caller holds the mutex
+    void sortPending();
+
+    mutable std::mutex mutex;
+    // Sorted farthest first, batches are taken from the back
+    std::vector<ChunkCoordinates> pending;
+    bool sorted = true;
+    int32_t centerX = 0;
+    int32_t centerZ = 0;
+    // Horizontal look direction
+    float lookX = 0.0f;
+    float lookZ = 1.0f;
+    size_t peak = 0;
+    float desiredChunksPerTick = 9.0f;
+    float batchQuota = 0.0f;
+    int unacknowledgedBatches = 0;
+    // A single batch until the client reported its rate for the first time
+    int maxUnacknowledgedBatches = 1;
+    bool batchInProgress = false;
+};
+
+// Start the next chunk batch of every player that is ready for one
+void tickChunkSending();
+std::string formatChunkSendStats();
+
+#endif // CHUNK_SENDER_H
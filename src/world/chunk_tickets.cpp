@@ -0,0 +1,169 @@
+#include "chunk_tickets.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "chunk.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+
+void ChunkTickets::add(int32_t chunkX, int32_t chunkZ) {
+    uint64_t key = packChunkCoordinates(chunkX, chunkZ);
+    std::lock_guard lock(mutex);
+    if (++counts[key] == 1) {
+        releasedAt.erase(key);
+    }
+}
+
+void ChunkTickets::remove(int32_t chunkX, int32_t chunkZ) {
+    uint64_t key = packChunkCoordinates(chunkX, chunkZ);
+    std::lock_guard lock(mutex);
+    auto it = counts.find(key);
+    if (it == counts.end()) {
+        return;
+    }
+    if (--it->second == 0) {
+        counts.erase(it);
+        // Chunks that were never loaded have nothing to unload
+        if (globalChunkMap.find(chunkX, chunkZ)) {
+            releasedAt[key] = Clock::now();
+        }
+    }
+}
+
+void ChunkTickets::unloadChunks() {
+    // Saving can take a while, a round still running is not overlapped
+    if (unloading.exchange(true)) {
+        return;
+    }
+    // Cleared however the round ends, or unloading would stop for good
+    struct UnloadingGuard {
+        std::atomic<bool>& flag;
+        ~UnloadingGuard() { flag = false; }
+    } unloadingGuard{unloading};
+
+    struct LoadedChunk {
+        std::shared_ptr<Chunk> chunk;
+        size_t bytes;
+        Clock::time_point released;
+    };
+
+    std::vector<LoadedChunk> loaded;
+    globalChunkMap.forEach([&](const std::shared_ptr<Chunk>& chunk) {
+        loaded.push_back({chunk, 0, {}});
+    });
+    size_t loadedBytes = 0;
+    for (auto& entry : loaded) {
+        std::lock_guard lock(entry.chunk->mutex);
+        entry.bytes = entry.chunk->memoryUsage();
+        loadedBytes += entry.bytes;
+    }
+
+    auto now = Clock::now();
+    std::vector<LoadedChunk> candidates;
+    {
+        std::lock_guard lock(mutex);
+        for (auto& entry : loaded) {
+            uint64_t key = packChunkCoordinates(entry.chunk->chunkX, entry.chunk->chunkZ);
+            if (counts.contains(key)) {
+                continue;
+            }
+            // Loaded without ever getting a ticket, e.g. by a block lookup
+            entry.released = releasedAt.try_emplace(key, now).first->second;
+            candidates.push_back(std::move(entry));
+        }
+    }
+    // Least recently released first
+    std::ranges::sort(candidates, {}, &LoadedChunk::released);
+
+    auto unloadDelay = std::chrono::seconds(serverConfig.chunkUnloadDelay);
+    size_t memoryBudget = static_cast<size_t>(serverConfig.chunkMemoryBudgetMb) << 20;
+    for (const auto& candidate : candidates) {
+        if (now - candidate.released < unloadDelay && loadedBytes <= memoryBudget) {
+            break;
+        }
+
+        const std::shared_ptr<Chunk>& chunk = candidate.chunk;
+        bool dirty;
+        {
+            std::lock_guard lock(chunk->mutex);
+            dirty = chunk->dirty;
+        }
+        if (dirty) {
+            try {
+                if (!saveChunkToDisk(chunk)) {
+                    continue;
+                }
+            } catch (const std::exception& e) {
+                // Stays loaded and is tried again in the next round
+                logMessage("Failed to save chunk " + std::to_string(chunk->chunkX) + ", " + std::to_string(chunk->chunkZ) + ": " + e.what(), LOG_ERROR);
+                continue;
+            }
+            ++chunksSaved;
+        }
+
+        uint64_t key = packChunkCoordinates(chunk->chunkX, chunk->chunkZ);
+        // The chunk lock comes first, the tickets are never locked before a chunk
+        std::lock_guard chunkLock(chunk->mutex);
+        // Changed again since it was saved, or an autosave is still writing it; it goes in the next round
+        if (chunk->dirty || chunk->writtenVersion != chunk->snapshotVersion) {
+            continue;
+        }
+        {
+            std::lock_guard lock(mutex);
+            // A player may have come back while the chunk was saved
+            if (counts.contains(key)) {
+                continue;
+            }
+            releasedAt.erase(key);
+            globalChunkMap.erase(chunk->chunkX, chunk->chunkZ);
+        }
+        loadedBytes -= candidate.bytes;
+        ++chunksEvicted;
+    }
+
+    if (loadedBytes > memoryBudget) {
+        logMessage("Loaded chunks use " + std::to_string(loadedBytes >> 20) + " MiB, over the budget of " + std::to_string(serverConfig.chunkMemoryBudgetMb) + " MiB, but all of them are in use", LOG_WARNING);
+    }
+}
+
+std::string ChunkTickets::formatStats() const {
+    std::vector<std::shared_ptr<Chunk>> loaded;
+    globalChunkMap.forEach([&](const std::shared_ptr<Chunk>& chunk) {
+        loaded.push_back(chunk);
+    });
+    size_t loadedBytes = 0;
+    size_t dirtyChunks = 0;
+    for (const auto& chunk : loaded) {
+        std::lock_guard lock(chunk->mutex);
+        loadedBytes += chunk->memoryUsage();
+        dirtyChunks += chunk->dirty ? 1 : 0;
+    }
+
+    size_t ticketed;
+    size_t releasing;
+    {
+        std::lock_guard lock(mutex);
+        ticketed = counts.size();
+        releasing = releasedAt.size();
+    }
+
+    char memory[64];
+    std::snprintf(memory, sizeof(memory), "%.1f MiB of %d MiB", static_cast<double>(loadedBytes) / (1 << 20), serverConfig.chunkMemoryBudgetMb);
+    return "Loaded chunks: " + std::to_string(loaded.size()) + " (" + memory + "), " + std::to_string(dirtyChunks) + " unsaved\n"
+        + "Tickets: " + std::to_string(ticketed) + " chunks held, " + std::to_string(releasing) + " waiting to unload\n"
+        + "Unloaded: " + std::to_string(chunksEvicted.load()) + " chunks, " + std::to_string(chunksSaved.load()) + " saved on the way out\n";
+}
+
+void addSpawnChunkTickets() {
+    int32_t spawnChunkX = getChunkCoordinate(spawnPosition.x);
+    int32_t spawnChunkZ = getChunkCoordinate(spawnPosition.z);
+    int radius = serverConfig.spawnChunkRadius;
+    for (int32_t dx = -radius; dx <= radius; ++dx) {
+        for (int32_t dz = -radius; dz <= radius; ++dz) {
+            chunkTickets.add(spawnChunkX + dx, spawnChunkZ + dz);
+        }
+    }
+}
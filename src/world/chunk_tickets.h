@@ -0,0 +1,55 @@
+#ifndef CHUNK_TICKETS_H
+#define CHUNK_TICKETS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Reference counts that keep chunks loaded: one per player viewing the chunk, one for the spawn area
+// and one for every task that is still working on the chunk.
+// Chunks without a ticket are saved if dirty and evicted after a grace period, or earlier,
+// least recently released first, while the loaded chunks exceed the memory budget.
+class ChunkTickets {
+public:
+    void add(int32_t chunkX, int32_t chunkZ);
+    void remove(int32_t chunkX, int32_t chunkZ);
+
+    // Saves and evicts the chunks that may go, run by the tick thread
+    void unloadChunks();
+
+    std::string formatStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, int> counts;
+    // When the loaded chunks without a ticket lost their last one
+    std::unordered_map<uint64_t, Clock::time_point> releasedAt;
+    std::atomic<bool> unloading{false};
+    std::atomic<uint64_t> chunksSaved{0};
+    std::atomic<uint64_t> chunksEvicted{0};
+};
+
+inline ChunkTickets chunkTickets;
+
+// Holds a ticket while some work on the chunk is pending
+class ChunkTicket {
+public:
+    ChunkTicket(int32_t chunkX, int32_t chunkZ) : chunkX(chunkX), chunkZ(chunkZ) { chunkTickets.add(chunkX, chunkZ); }
+    ~ChunkTicket() { chunkTickets.remove(chunkX, chunkZ); }
+    ChunkTicket(const ChunkTicket&) = delete;
+    ChunkTicket& operator=(const ChunkTicket&) = delete;
+
+private:
+    int32_t chunkX;
+    int32_t chunkZ;
+};
+
+// Keeps the chunks around the world spawn loaded
+void addSpawnChunkTickets();
+
+#endif // CHUNK_TICKETS_H
@@ -1,46 +1,52 @@
 #include "region_file.h"
 
+#include <cerrno>
+#include <ctime>
 #include <iostream>
 #include <sstream>
 #include <tag_array.h>
 #include <cstring>
-
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "chunk_map.h"
+#include "core/config.h"
 #include "core/utils.h"
 #include "zlib.h"
 #include "io/stream_reader.h"
 
-RegionFile::RegionFile(const std::filesystem::path& filepath, bool readOnly) : filepath(filepath) {
-    // Open the file in binary read/write mode
-    if (readOnly) {
-        fileStream.open(filepath, std::ios::in | std::ios::binary);
-    } else {
-        fileStream.open(filepath, std::ios::in | std::ios::out | std::ios::binary);
-    }
-
-    // If the file doesn't exist, create it and initialize header
-    if(!readOnly) {
-        if (!fileStream.is_open()) {
-            fileStream.clear();
-            fileStream.open(filepath, std::ios::out | std::ios::binary);
-            if (!fileStream) {
-                logMessage("Failed to create/open region file: " + filepath.string(), LOG_ERROR);
-                return;
-            }
+RegionFile::RegionFile(const std::filesystem::path& filepath, bool create) : filepath(filepath) {
+#ifdef _WIN32
+    file = CreateFileW(filepath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                       create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    writable = file != INVALID_HANDLE_VALUE;
+    if (!writable && !create) {
+        file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+#else
+    file = open(filepath.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+    writable = file >= 0;
+    if (!writable && !create) {
+        // Loading still works from a read-only world
+        file = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+#endif
+    if (!isOpen()) {
+        logMessage("Failed to open region file: " + filepath.string(), LOG_ERROR);
+        return;
+    }
 
-            // Initialize header with zeros
-            std::array<uint8_t, 8192> emptyHeader = {0};
-            fileStream.write(reinterpret_cast<const char*>(emptyHeader.data()), emptyHeader.size());
-            fileStream.close();
-            // Reopen in read/write mode
-            fileStream.open(filepath, std::ios::in | std::ios::out | std::ios::binary);
-            if (!fileStream) {
-                logMessage("Failed to reopen region file after creation: " + filepath.string(), LOG_ERROR);
-                return;
-            }
-        }
-    } else {
-        if (!fileStream.is_open()) {
-            logMessage("Failed to open region file: " + filepath.string(), LOG_ERROR);
+    // A new file starts with an empty header
+    if (writable && getFileSize() < 8192) {
+        std::array<uint8_t, 8192> emptyHeader = {0};
+        if (!writeAt(0, emptyHeader.data(), emptyHeader.size())) {
+            logMessage("Failed to initialize region file: " + filepath.string(), LOG_ERROR);
         }
     }
 
@@ -51,72 +57,154 @@ RegionFile::RegionFile(const std::filesystem::path& filepath, bool readOnly) : f
 }
 
 RegionFile::~RegionFile() {
-    if (fileStream.is_open()) {
-        // Write the header back before closing
-        writeHeader();
-        fileStream.close();
+    if (isOpen()) {
+#ifdef _WIN32
+        CloseHandle(file);
+#else
+        close(file);
+#endif
     }
 }
 
-bool RegionFile::loadHeader() {
-    if (!fileStream.is_open()) {
-        logMessage("Region file not open: " + filepath.string(), LOG_ERROR);
-        return false;
+bool RegionFile::isOpen() const {
+#ifdef _WIN32
+    return file != INVALID_HANDLE_VALUE;
+#else
+    return file >= 0;
+#endif
+}
+
+size_t RegionFile::readAt(uint64_t offset, void* buffer, size_t length) const {
+    auto* out = static_cast<uint8_t*>(buffer);
+    size_t total = 0;
+    while (total < length) {
+#ifdef _WIN32
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset + total);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + total) >> 32);
+        DWORD bytesRead = 0;
+        if (!ReadFile(file, out + total, static_cast<DWORD>(length - total), &bytesRead, &overlapped) || bytesRead == 0) {
+            break;
+        }
+#else
+        ssize_t bytesRead = pread(file, out + total, length - total, static_cast<off_t>(offset + total));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            break;
+        }
+#endif
+        total += bytesRead;
     }
+    return total;
+}
 
-    // Read the first 4,096 bytes for chunk offset table
-    fileStream.seekg(0, std::ios::beg);
-    for (size_t i = 0; i < 1024; ++i) {
-        uint32_t offset = 0;
-        fileStream.read(reinterpret_cast<char*>(&offset), 4);
-        // Convert from big-endian to host byte order
-        offset = ((offset & 0xFF) << 16) | ((offset & 0xFF00) << 8) | ((offset & 0xFF0000) >> 8);
-        chunkOffsetTable[i] = offset;
+bool RegionFile::writeAt(uint64_t offset, const void* data, size_t length) {
+    const auto* in = static_cast<const uint8_t*>(data);
+    size_t total = 0;
+    while (total < length) {
+#ifdef _WIN32
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset + total);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + total) >> 32);
+        DWORD bytesWritten = 0;
+        if (!WriteFile(file, in + total, static_cast<DWORD>(length - total), &bytesWritten, &overlapped) || bytesWritten == 0) {
+            return false;
+        }
+#else
+        ssize_t bytesWritten = pwrite(file, in + total, length - total, static_cast<off_t>(offset + total));
+        if (bytesWritten < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesWritten <= 0) {
+            return false;
+        }
+#endif
+        total += bytesWritten;
     }
+    return true;
+}
+
+uint64_t RegionFile::getFileSize() const {
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    return GetFileSizeEx(file, &size) ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+    struct stat status = {};
+    return fstat(file, &status) == 0 ? static_cast<uint64_t>(status.st_size) : 0;
+#endif
+}
 
-    // Read the next 4,096 bytes for chunk timestamp table
+static uint32_t readUInt32BigEndian(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+static void writeUInt32BigEndian(uint8_t* data, uint32_t value) {
+    data[0] = static_cast<uint8_t>(value >> 24);
+    data[1] = static_cast<uint8_t>(value >> 16);
+    data[2] = static_cast<uint8_t>(value >> 8);
+    data[3] = static_cast<uint8_t>(value);
+}
+
+bool RegionFile::loadHeader() {
+    // 4 KiB of chunk locations, then 4 KiB of timestamps
+    std::array<uint8_t, 8192> header = {0};
+    if (readAt(0, header.data(), header.size()) != header.size()) {
+        return false;
+    }
     for (size_t i = 0; i < 1024; ++i) {
-        uint32_t timestamp = 0;
-        fileStream.read(reinterpret_cast<char*>(&timestamp), 4);
-        // Convert from big-endian to host byte order
-        timestamp = ((timestamp & 0xFF) << 24) | ((timestamp & 0xFF00) << 8) |
-                    ((timestamp & 0xFF0000) >> 8) | ((timestamp & 0xFF000000) >> 24);
-        chunkTimestampTable[i] = timestamp;
+        // 3 bytes sector offset and 1 byte sector count
+        chunkOffsetTable[i] = readUInt32BigEndian(header.data() + i * 4);
+        chunkTimestampTable[i] = readUInt32BigEndian(header.data() + 4096 + i * 4);
     }
 
+    usedSectors.assign(2, true);
+    for (uint32_t entry : chunkOffsetTable) {
+        setSectorsUsed(entry >> 8, entry & 0xFF, true);
+    }
     return true;
 }
 
-bool RegionFile::writeHeader() {
-    if (!fileStream.is_open()) {
-        logMessage("Region file not open: " + filepath.string(), LOG_ERROR);
-        return false;
+uint32_t RegionFile::allocateSectors(uint32_t count) {
+    uint32_t runStart = 2;
+    uint32_t runLength = 0;
+    for (uint32_t sector = 2; sector < usedSectors.size() && runLength < count; ++sector) {
+        if (usedSectors[sector]) {
+            runStart = sector + 1;
+            runLength = 0;
+        } else {
+            ++runLength;
+        }
     }
+    // A free run reaching the end of the file is extended past it
+    setSectorsUsed(runStart, count, true);
+    return runStart;
+}
 
-    // Write the chunk offset table
-    fileStream.seekp(0, std::ios::beg);
-    for (size_t i = 0; i < 1024; ++i) {
-        uint32_t offset = chunkOffsetTable[i];
-        // Convert to big-endian
-        uint32_t beOffset = ((offset & 0xFF0000) >> 8) |
-							((offset & 0xFF00) << 8) |
-							((offset & 0xFF) << 16);
-        fileStream.write(reinterpret_cast<const char*>(&beOffset), 4);
+void RegionFile::setSectorsUsed(uint32_t offset, uint32_t count, bool used) {
+    if (used && offset + count > usedSectors.size()) {
+        usedSectors.resize(offset + count, false);
+    }
+    for (uint32_t sector = offset; sector < offset + count && sector < usedSectors.size(); ++sector) {
+        usedSectors[sector] = used;
     }
+}
 
-    // Write the chunk timestamp table
-    for (size_t i = 0; i < 1024; ++i) {
-        uint32_t timestamp = chunkTimestampTable[i];
-        // Convert to big-endian
-        uint32_t beTimestamp = ((timestamp & 0xFF000000) >> 24) |
-                               ((timestamp & 0xFF0000) >> 8) |
-                               ((timestamp & 0xFF00) << 8) |
-                               ((timestamp & 0xFF) << 24);
-        fileStream.write(reinterpret_cast<const char*>(&beTimestamp), 4);
+bool RegionFile::writeHeaderEntry(int index) {
+    uint8_t entry[4];
+    writeUInt32BigEndian(entry, chunkOffsetTable[index]);
+    if (!writeAt(static_cast<uint64_t>(index) * 4, entry, sizeof(entry))) {
+        return false;
     }
+    writeUInt32BigEndian(entry, chunkTimestampTable[index]);
+    return writeAt(4096 + static_cast<uint64_t>(index) * 4, entry, sizeof(entry));
+}
 
-    fileStream.flush();
-    return true;
+bool RegionFile::hasChunk(int localX, int localZ) {
+    std::shared_lock lock(mutex);
+    return getChunkLocation(localX, localZ).has_value();
 }
 
 int RegionFile::getChunkIndex(int localX, int localZ) {
@@ -147,44 +235,42 @@ std::optional<ChunkData> RegionFile::loadChunk(int localX, int localZ, int regio
         return std::nullopt;
     }
 
-    int index = getChunkIndex(localX, localZ);
-    uint32_t offset = chunkOffsetTable[index] >> 8; // The first 3 bytes
-    uint8_t sectorCount = chunkOffsetTable[index] & 0xFF; // The last byte
+    // All sectors of the chunk in one read; the lock keeps a save from moving the chunk meanwhile
+    std::vector<uint8_t> sectors;
+    size_t bytesRead;
+    {
+        std::shared_lock lock(mutex);
+        auto location = getChunkLocation(localX, localZ);
+        if (!location.has_value()) {
+            // Chunk not present
+            return std::nullopt;
+        }
+        auto [offset, sectorCount] = location.value();
+        sectors.resize(static_cast<size_t>(sectorCount) * 4096);
+        bytesRead = readAt(static_cast<uint64_t>(offset) * 4096, sectors.data(), sectors.size());
+    }
 
-    if (offset == 0 && sectorCount == 0) {
-        // Chunk not present
+    // Chunk length, then the compression type
+    uint32_t length = bytesRead >= 5 ? readUInt32BigEndian(sectors.data()) : 0;
+    if (length < 1 || length > bytesRead - 4) {
+        logMessage("Invalid data for chunk (" + std::to_string(localX) + ", " + std::to_string(localZ) + ") in region file: " + filepath.string(), LOG_ERROR);
         return std::nullopt;
     }
-
-    // Calculate byte offset
-    uint64_t byteOffset = static_cast<uint64_t>(offset) * 4096;
-
-    // Read chunk length
-    fileStream.seekg(byteOffset, std::ios::beg);
-    uint32_t length = 0;
-    fileStream.read(reinterpret_cast<char*>(&length), 4);
-    // Convert from big-endian
-    length = ((length & 0xFF) << 24) | ((length & 0xFF00) << 8) |
-             ((length & 0xFF0000) >> 8) | ((length & 0xFF000000) >> 24);
-
-    // Read compression type
-    uint8_t compressionType = 0;
-    fileStream.read(reinterpret_cast<char*>(&compressionType), 1);
+    uint8_t compressionType = sectors[4];
     if (compressionType != 2) { // Only handle zlib compression
-        logMessage("Unsupported compression type: " + static_cast<int>(compressionType), LOG_ERROR);
+        logMessage("Unsupported compression type: " + std::to_string(compressionType), LOG_ERROR);
         return std::nullopt;
     }
 
-    // Read compressed data
+    // Compressed data
     size_t compressedSize = length - 1;
-    std::vector<uint8_t> compressedData(compressedSize);
-    fileStream.read(reinterpret_cast<char*>(compressedData.data()), compressedSize);
+    uint8_t* compressedData = sectors.data() + 5;
 
     // Decompress using zlib
     std::vector<uint8_t> decompressedData;
     {
         z_stream strm = {};
-        strm.next_in = compressedData.data();
+        strm.next_in = compressedData;
         strm.avail_in = compressedSize;
 
         if (inflateInit(&strm) != Z_OK) {
@@ -262,8 +348,6 @@ bool RegionFile::saveChunk(int localX, int localZ, int regionX, int regionZ, con
     }
 
     int index = getChunkIndex(localX, localZ);
-    uint32_t currentOffset = chunkOffsetTable[index] >> 8;
-    uint8_t currentSectorCount = chunkOffsetTable[index] & 0xFF;
 
     // Serialize NBT data
     std::ostringstream nbtStream(std::ios::binary);
@@ -314,49 +398,100 @@ bool RegionFile::saveChunk(int localX, int localZ, int regionX, int regionZ, con
     // Determine compression type
     uint8_t compressionType = 2; // zlib
 
-    // Prepare chunk data
-    std::vector<uint8_t> chunkData;
-    uint32_t chunkLength = static_cast<uint32_t>(1 + compressedData.size()); // 1 byte for compression type
-
-    // Convert chunkLength to big-endian
-    uint32_t beChunkLength = ((chunkLength & 0xFF000000) >> 24) |
-                              ((chunkLength & 0x00FF0000) >> 8) |
-                              ((chunkLength & 0x0000FF00) << 8) |
-                              ((chunkLength & 0x000000FF) << 24);
-    chunkData.resize(4 + 1 + compressedData.size());
-    memcpy(chunkData.data(), &beChunkLength, 4);
+    // Calculate required sectors
+    size_t totalBytes = 4 + 1 + compressedData.size(); // Length and compression type before the data
+    size_t requiredSectors = (totalBytes + 4095) / 4096; // Ceiling division
+    if (requiredSectors > 255) {
+        logMessage("Chunk (" + std::to_string(localX) + ", " + std::to_string(localZ) + ") is too large for region file: " + filepath.string(), LOG_ERROR);
+        return false;
+    }
+
+    // Prepare chunk data, padded to whole sectors
+    std::vector<uint8_t> chunkData(requiredSectors * 4096, 0);
+    writeUInt32BigEndian(chunkData.data(), static_cast<uint32_t>(1 + compressedData.size())); // 1 byte for compression type
     chunkData[4] = compressionType;
     memcpy(chunkData.data() + 5, compressedData.data(), compressedData.size());
 
-    // Calculate required sectors
-    size_t totalBytes = chunkData.size();
-    uint8_t requiredSectors = static_cast<uint8_t>((totalBytes + 4095) / 4096); // Ceiling division
+    std::unique_lock lock(mutex);
+    if (!writable) {
+        logMessage("Region file is read-only: " + filepath.string(), LOG_ERROR);
+        return false;
+    }
 
-    // Find a suitable location (for simplicity, append to the end)
-    fileStream.seekp(0, std::ios::end);
-    uint64_t fileSize = fileStream.tellp();
-    uint32_t newOffset = static_cast<uint32_t>((fileSize + 4095) / 4096); // Ceiling division
+    // The old sectors stay allocated until the header points at the new ones, so a crash leaves one complete copy
+    std::optional<std::pair<uint32_t, uint8_t>> previousLocation = getChunkLocation(localX, localZ);
+    uint32_t newOffset = allocateSectors(static_cast<uint32_t>(requiredSectors));
+
+    // Write chunk data before pointing the header at it
+    if (!writeAt(static_cast<uint64_t>(newOffset) * 4096, chunkData.data(), chunkData.size())) {
+        logMessage("Failed to write chunk (" + std::to_string(localX) + ", " + std::to_string(localZ) + ") to region file: " + filepath.string(), LOG_ERROR);
+        setSectorsUsed(newOffset, static_cast<uint32_t>(requiredSectors), false);
+        return false;
+    }
 
     // Update chunk offset table
-    chunkOffsetTable[index] = (newOffset << 8) | requiredSectors;
+    uint32_t previousOffset = chunkOffsetTable[index];
+    uint32_t previousTimestamp = chunkTimestampTable[index];
+    setChunkLocation(localX, localZ, newOffset, static_cast<uint8_t>(requiredSectors));
 
     // Update chunk timestamp (current epoch time)
-    uint32_t currentTimestamp = static_cast<uint32_t>(std::time(nullptr));
-    chunkTimestampTable[index] = currentTimestamp;
+    chunkTimestampTable[index] = static_cast<uint32_t>(std::time(nullptr));
 
-    // Write chunk data
-    uint64_t byteOffset = static_cast<uint64_t>(newOffset) * 4096;
-    fileStream.seekp(byteOffset, std::ios::beg);
-    fileStream.write(reinterpret_cast<const char*>(chunkData.data()), chunkData.size());
+    if ((chunkOffsetTable[index] != previousOffset || chunkTimestampTable[index] != previousTimestamp) && !writeHeaderEntry(index)) {
+        logMessage("Failed to update the header of region file: " + filepath.string(), LOG_ERROR);
+        chunkOffsetTable[index] = previousOffset;
+        chunkTimestampTable[index] = previousTimestamp;
+        setSectorsUsed(newOffset, static_cast<uint32_t>(requiredSectors), false);
+        return false;
+    }
 
-    // Pad the remaining space in the sector with zeros
-    size_t paddingSize = (requiredSectors * 4096) - chunkData.size();
-    if (paddingSize > 0) {
-        std::vector<uint8_t> padding(paddingSize, 0);
-        fileStream.write(reinterpret_cast<const char*>(padding.data()), padding.size());
+    if (previousLocation.has_value()) {
+        setSectorsUsed(previousLocation->first, previousLocation->second, false);
+    }
+    return true;
+}
+std::shared_ptr<RegionFile> RegionFileCache::get(int regionX, int regionZ, bool create) {
+    uint64_t key = packChunkCoordinates(regionX, regionZ);
+    std::lock_guard lock(mutex);
+    if (auto it = files.find(key); it != files.end()) {
+        it->second.lastUse = ++useCounter;
+        return it->second.file;
     }
 
-    fileStream.flush();
+    std::filesystem::path path = directory / ("r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".mca");
+    std::error_code error;
+    if (create) {
+        std::filesystem::create_directories(directory, error);
+    } else if (!std::filesystem::exists(path, error)) {
+        return nullptr;
+    }
+    auto file = std::make_shared<RegionFile>(path, create);
+    if (!file->isOpen()) {
+        return nullptr;
+    }
 
-    return true;
-}
\ No newline at end of file
+    files[key] = {file, ++useCounter};
+    evict();
+    return file;
+}
+
+size_t RegionFileCache::size() const {
+    std::lock_guard lock(mutex);
+    return files.size();
+}
+
+void RegionFileCache::evict() {
+    while (files.size() > static_cast<size_t>(serverConfig.regionFileCacheSize)) {
+        // A file still in use stays open, a second instance would not see its header changes
+        auto oldest = files.end();
+        for (auto it = files.begin(); it != files.end(); ++it) {
+            if (it->second.file.use_count() == 1 && (oldest == files.end() || it->second.lastUse < oldest->second.lastUse)) {
+                oldest = it;
+            }
+        }
+        if (oldest == files.end()) {
+            return;
+        }
+        files.erase(oldest);
+    }
+}
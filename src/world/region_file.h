@@ -2,8 +2,10 @@
 #define REGION_FILE_H
 #include <array>
 #include <cstdint>
-#include <fstream>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <tag_compound.h>
 #include <unordered_map>
@@ -24,12 +26,22 @@ struct ChunkData {
     Heightmaps heightmaps;
 };
 
+// An open region file with its header kept in memory.
+// Chunks are read and written at their offset without a shared file position, so loads from any number of threads
+// run in parallel; a save excludes the loads of the same file while it moves a chunk.
 class RegionFile {
 public:
-    RegionFile(const std::filesystem::path &filepath, bool readOnly);
+    // Creates the file with an empty header if create is set and it doesn't exist yet
+    RegionFile(const std::filesystem::path &filepath, bool create);
 
     ~RegionFile();
 
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] bool hasChunk(int localX, int localZ);
+
     // Load a chunk at local (x, z) within the region (0-31)
     std::optional<ChunkData> loadChunk(int localX, int localZ, int regionX, int regionZ);
 
@@ -38,14 +50,33 @@ public:
 
 private:
     std::filesystem::path filepath;
-    std::fstream fileStream;
+#ifdef _WIN32
+    void* file; // HANDLE
+#else
+    int file;
+#endif
+    bool writable = false;
+
+    // Guards the header tables and the sectors they point to
+    std::shared_mutex mutex;
 
     // Header data
-    std::array<uint32_t, 1024> chunkOffsetTable;
-    std::array<uint32_t, 1024> chunkTimestampTable;
+    std::array<uint32_t, 1024> chunkOffsetTable{};
+    std::array<uint32_t, 1024> chunkTimestampTable{};
+    // One flag per 4 KiB sector, set for the header and the sectors of every chunk
+    std::vector<bool> usedSectors;
 
     bool loadHeader();
-    bool writeHeader();
+    // First run of free sectors that fits, at the end of the file if none does
+    uint32_t allocateSectors(uint32_t count);
+    void setSectorsUsed(uint32_t offset, uint32_t count, bool used);
+    // Writes the offset and timestamp of one chunk, the only header entries a save changes
+    bool writeHeaderEntry(int index);
+
+    // Positional reads and writes, the file has no shared position; a read returns the bytes read before the end of the file
+    size_t readAt(uint64_t offset, void* buffer, size_t length) const;
+    bool writeAt(uint64_t offset, const void* data, size_t length);
+    [[nodiscard]] uint64_t getFileSize() const;
 
     // Utility functions
     static int getChunkIndex(int localX, int localZ);
@@ -53,4 +84,31 @@ private:
     bool setChunkLocation(int localX, int localZ, uint32_t offset, uint8_t sectorCount);
 };
 
+// The recently used region files of a world, kept open up to region_file_cache_size.
+// The least recently used file that no thread is using is closed first.
+class RegionFileCache {
+public:
+    explicit RegionFileCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+    // The region file, or nullptr if it doesn't exist and create is not set
+    std::shared_ptr<RegionFile> get(int regionX, int regionZ, bool create);
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct CachedFile {
+        std::shared_ptr<RegionFile> file;
+        uint64_t lastUse;
+    };
+
+    std::filesystem::path directory;
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, CachedFile> files;
+    uint64_t useCounter = 0;
+
+    void evict();
+};
+
+inline RegionFileCache regionFileCache("world/region");
+
 #endif //REGION_FILE_H
@@ -13,6 +13,7 @@
 #include "core/server.h"
 #include "core/utils.h"
 #include "tag_primitive.h"
+#include "world_saver.h"
 
 World::World(const std::string& worldPath) : path(worldPath) {}
 
@@ -221,8 +222,7 @@ bool World::load() {
 }
 
 bool World::save() {
-    // TODO: Implement saving logic
-    return true;
+    return worldSaver.flush();
 }
 
 bool World::loadLevelDat() const {
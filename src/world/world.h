@@ -19,6 +19,7 @@ public:
 
     bool load();
 
+    // Writes every unsaved chunk and waits for the autosave writes in progress
     static bool save();
 
 private:
@@ -0,0 +1,78 @@
+#include "world_saver.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+
+// Ticks an autosave is spread over
+constexpr size_t AUTOSAVE_SPREAD_TICKS = 100;
+
+void WorldSaver::tick() {
+    if (autosaveQueue.empty() && serverConfig.autosaveInterval > 0
+        && ++ticksSinceAutosave >= serverConfig.autosaveInterval * serverConfig.ticksPerSecond) {
+        ticksSinceAutosave = 0;
+        globalChunkMap.forEach([this](const std::shared_ptr<Chunk>& chunk) {
+            autosaveQueue.push_back(chunk);
+        });
+        chunksPerTick = std::max<size_t>(1, (autosaveQueue.size() + AUTOSAVE_SPREAD_TICKS - 1) / AUTOSAVE_SPREAD_TICKS);
+    }
+
+    for (size_t visited = 0; visited < chunksPerTick && !autosaveQueue.empty(); ++visited) {
+        // Chunks unloaded since the autosave started were saved on the way out
+        std::shared_ptr<Chunk> chunk = autosaveQueue.front().lock();
+        autosaveQueue.pop_front();
+        if (!chunk) {
+            continue;
+        }
+        if (std::optional<ChunkSnapshot> snapshot = snapshotChunk(chunk)) {
+            writeAsync(std::move(snapshot.value()));
+        }
+    }
+}
+
+void WorldSaver::writeAsync(ChunkSnapshot snapshot) {
+    {
+        std::lock_guard lock(mutex);
+        ++pendingWrites;
+    }
+    threadPool.enqueue([this, snapshot = std::move(snapshot)] {
+        try {
+            writeChunkSnapshot(snapshot);
+        } catch (const std::exception& e) {
+            logMessage("Failed to save chunk (" + std::to_string(snapshot.chunk->chunkX) + ", " + std::to_string(snapshot.chunk->chunkZ) + "): " + e.what(), LOG_ERROR);
+            std::lock_guard chunkLock(snapshot.chunk->mutex);
+            snapshot.chunk->dirty = true;
+        }
+        std::lock_guard lock(mutex);
+        if (--pendingWrites == 0) {
+            writesDone.notify_all();
+        }
+    });
+}
+
+bool WorldSaver::flush() {
+    std::vector<std::shared_ptr<Chunk>> loaded;
+    globalChunkMap.forEach([&](const std::shared_ptr<Chunk>& chunk) {
+        loaded.push_back(chunk);
+    });
+
+    size_t saved = 0;
+    size_t failed = 0;
+    for (const auto& chunk : loaded) {
+        if (std::optional<ChunkSnapshot> snapshot = snapshotChunk(chunk)) {
+            if (writeChunkSnapshot(snapshot.value())) {
+                ++saved;
+            } else {
+                ++failed;
+            }
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    writesDone.wait(lock, [this] { return pendingWrites == 0; });
+    logMessage("Saved " + std::to_string(saved) + " chunks", LOG_INFO);
+    return failed == 0;
+}
@@ -0,0 +1,38 @@
+#ifndef WORLD_SAVER_H
+#define WORLD_SAVER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "chunk.h"
+
+// Writes the changed chunks to their region files without stalling the tick.
+// An autosave goes through the loaded chunks over the following ticks: the dirty ones are copied on the tick thread,
+// then serialized, compressed and written on the thread pool.
+class WorldSaver {
+public:
+    // Called by the tick thread every tick
+    void tick();
+
+    // Saves every dirty chunk on the calling thread and waits for the autosave writes still running
+    bool flush();
+
+private:
+    void writeAsync(ChunkSnapshot snapshot);
+
+    // Only used by the tick thread
+    std::deque<std::weak_ptr<Chunk>> autosaveQueue;
+    size_t chunksPerTick = 1;
+    int ticksSinceAutosave = 0;
+
+    std::mutex mutex;
+    std::condition_variable writesDone;
+    size_t pendingWrites = 0;
+};
+
+inline WorldSaver worldSaver;
+
+#endif // WORLD_SAVER_H